@@ -7,11 +7,52 @@
 // Supports insert, search, delete, and display operations
 // Time Complexity: O(1) average, O(n) worst case
 // Space Complexity: O(n)
+//
+// FlatHashMap is an open-addressing alternative with the same interface:
+// entries are stored inline and probed a whole group of slots at a time
+// (SSE2 / AVX2 when available), Swiss-table style
+//
+// Both engines take a Hasher template parameter; the defaults are seeded per
+// table (wyhash-style for strings, multiply-xorshift for integers)
+//
+// ConcurrentHashMap splits the key space into independently locked shards;
+// readers never lock and are protected by epoch-based reclamation
+//
+// HashMap::saveSnapshot writes a versioned on-disk image that MappedHashMap
+// reopens read-only with mmap and searches in place
+//
+// No operation writes to the console except display(). Build with
+// -DHASHMAP_STATS to also count hits, misses and probes (see getStats())
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <type_traits>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <string_view>
+#include <memory>
+#include <fstream>
+#include <cstdio>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 using namespace std;
 
 // ============================================================================
@@ -24,167 +65,1889 @@ struct Node {
     V value;         // Value of the pair
     Node* next;      // Pointer to next node
 
-    Node(K k, V v) : key(k), value(v), next(nullptr) {}
+    // Key and value are constructed in place from whatever the caller passed
+    template <typename KArg, typename... VArgs>
+    Node(KArg&& k, VArgs&&... v)
+        : key(std::forward<KArg>(k)), value(std::forward<VArgs>(v)...), next(nullptr) {}
 };
 
 // ============================================================================
-// HASH MAP CLASS
+// NODE POOL (Slab allocator for chain nodes)
+// ============================================================================
+// Nodes are carved out of slabs of SLAB_SIZE and recycled through a free
+// list, so inserting a key costs no call to the global allocator once the
+// pool is warm. Memory is returned to the system only when the pool dies.
+
+template <typename T>
+class NodePool {
+private:
+    static const size_t SLAB_SIZE = 256;
+
+    union FreeSlot {
+        FreeSlot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    vector<FreeSlot*> slabs;   // Every slab ever allocated
+    FreeSlot* freeList;        // Recycled slots
+    size_t slabUsed;           // Slots handed out from the newest slab
+
+public:
+    NodePool() : freeList(nullptr), slabUsed(SLAB_SIZE) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Construct a T in pooled memory
+    template <typename... Args>
+    T* create(Args&&... args) {
+        FreeSlot* slot;
+
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->next;
+        } else {
+            if (slabUsed == SLAB_SIZE) {
+                slabs.push_back(static_cast<FreeSlot*>(::operator new(SLAB_SIZE * sizeof(FreeSlot))));
+                slabUsed = 0;
+            }
+            slot = &slabs.back()[slabUsed++];
+        }
+
+        try {
+            return new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+    }
+
+    // Bytes held in slabs (live + recycled nodes)
+    size_t bytesReserved() const {
+        return slabs.size() * SLAB_SIZE * sizeof(FreeSlot);
+    }
+
+    // Destroy a T and keep its memory for the next create()
+    void destroy(T* object) {
+        object->~T();
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    ~NodePool() {
+        for (FreeSlot* slab : slabs)
+            ::operator delete(slab);
+    }
+};
+
 // ============================================================================
+// HASH FUNCTIONS
+// ============================================================================
+// A Hasher is any type with: uint64_t operator()(const K& key, uint64_t seed)
+// Every table draws its own random seed, so an attacker who knows the hash
+// function still cannot predict which keys will land in the same bucket
+
+const uint64_t WY_P0 = 0xa0761d6478bd642fULL;
+const uint64_t WY_P1 = 0xe7037ed1a0b428dbULL;
+const uint64_t WY_P2 = 0x8ebc6af09c88c6dbULL;
+const uint64_t WY_P3 = 0x589965cc75374cc3ULL;
+
+// 64x64 -> 128 bit multiply, folded back to 64 bits
+inline uint64_t wyMix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+    return lo ^ hi;
+#endif
+}
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// wyhash-style hash of a byte string: 16 bytes per multiply, 48 per round
+// on long inputs, every input byte influences every output bit
+inline uint64_t hashBytes(const void* data, size_t len, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t a, b;
+
+    seed ^= wyMix(seed ^ WY_P0, WY_P1);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t mid = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + mid);
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wyMix(read64(p) ^ WY_P1, read64(p + 8) ^ seed);
+                see1 = wyMix(read64(p + 16) ^ WY_P2, read64(p + 24) ^ see1);
+                see2 = wyMix(read64(p + 32) ^ WY_P3, read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = wyMix(read64(p) ^ WY_P1, read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+
+    return wyMix(WY_P1 ^ len, wyMix(a ^ WY_P1, b ^ seed));
+}
+
+// Multiply-xorshift mixer for integers: sequential IDs end up spread
+// across the whole 64-bit range, low bits included
+inline uint64_t hashInteger(uint64_t x, uint64_t seed) {
+    x += seed;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+// Default hasher: integers are mixed directly, everything else goes
+// through std::hash and is then mixed with the seed
+template <typename K>
+struct DefaultHasher {
+    uint64_t operator()(const K& key, uint64_t seed) const {
+        if constexpr (is_integral<K>::value || is_enum<K>::value)
+            return hashInteger((uint64_t)key, seed);
+        else
+            return hashInteger((uint64_t)std::hash<K>()(key), seed);
+    }
+};
+
+// Strings are hashed over their bytes
+// Transparent: string, string_view and const char* hash identically, so a
+// HashMap<string, ...> can be searched without building a std::string
+template <>
+struct DefaultHasher<string> {
+    typedef void is_transparent;
+
+    uint64_t operator()(string_view key, uint64_t seed) const {
+        return hashBytes(key.data(), key.size(), seed);
+    }
+};
 
+// True when a Hasher accepts lookup types other than K
+template <typename H, typename = void>
+struct IsTransparentHasher : false_type {};
+
+template <typename H>
+struct IsTransparentHasher<H, void_t<typename H::is_transparent>> : true_type {};
+
+// A fresh seed for every table: process-wide entropy mixed with a counter
+inline uint64_t randomHashSeed() {
+    static const uint64_t processSeed =
+        ((uint64_t)random_device()() << 32) ^ random_device()() ^
+        (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+    static atomic<uint64_t> counter(0);
+
+    return hashInteger(counter.fetch_add(1, memory_order_relaxed), processSeed);
+}
+
+// Hint the CPU to start loading the cache line holding p
+inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(__SSE2__)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+// ============================================================================
+// SNAPSHOT FORMAT (On-disk image for MappedHashMap)
+// ============================================================================
+// Everything is fixed-size and offset-based, so a mapped file is searched
+// directly without deserializing anything:
+//
+//   [SnapshotHeader]
+//   [uint64_t bucketStart[bucketCount + 1]]   entries of bucket b are
+//                                             entries[bucketStart[b] .. bucketStart[b+1])
+//   [SnapshotEntry<V> entries[entryCount]]    grouped by bucket
+//   [char keyBytes[]]                         key bytes, referenced by offset
+//
+// Integers are stored in host byte order; endianTag rejects foreign files
+
+const char SNAPSHOT_MAGIC[8] = {'H', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_ENDIAN_TAG = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t seed;            // Hash seed the bucket layout was built with
+    uint64_t hasherCheck;     // Hasher(K(), seed), catches a mismatched Hasher
+    uint64_t bucketCount;     // Power of two
+    uint64_t entryCount;
+    uint64_t bucketsOffset;
+    uint64_t entriesOffset;
+    uint64_t keysOffset;
+    uint64_t fileSize;
+    uint32_t keyIsString;     // 1: std::string keys, 0: fixed-size keys
+    uint32_t keySize;         // sizeof(K) for fixed-size keys
+    uint32_t valueSize;       // sizeof(V)
+    uint32_t reserved;
+};
+
+template <typename V>
+struct SnapshotEntry {
+    uint64_t hash;            // Full hash, compared before the key bytes
+    uint64_t keyOffset;       // Into the key bytes section
+    uint64_t keyLength;
+    V value;
+};
+
+// One entry to be written (points into the live table)
+template <typename V>
+struct SnapshotSource {
+    uint64_t hash;
+    const char* keyData;
+    size_t keyLength;
+    const V* value;
+};
+
+// Key bytes as stored in a snapshot: the characters of a string, or the
+// object representation of a fixed-size key
+template <typename K>
+string_view snapshotKeyBytes(const K& key) {
+    if constexpr (is_same<K, string>::value)
+        return string_view(key);
+    else
+        return string_view(reinterpret_cast<const char*>(&key), sizeof(K));
+}
+
+inline uint64_t alignOffset(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Lay out and write a snapshot; returns false on I/O failure
 template <typename K, typename V>
+bool writeSnapshot(const string& path, uint64_t seed, uint64_t hasherCheck,
+                   const vector<SnapshotSource<V>>& sources) {
+    static_assert(is_trivially_copyable<V>::value, "snapshot values must be trivially copyable");
+    static_assert(is_same<K, string>::value || is_trivially_copyable<K>::value,
+                  "snapshot keys must be std::string or trivially copyable");
+
+    uint64_t bucketCount = 1;
+    while (bucketCount < sources.size())
+        bucketCount *= 2;
+
+    // Counting sort of the entries by bucket
+    vector<uint64_t> bucketStart(bucketCount + 1, 0);
+    for (const SnapshotSource<V>& src : sources)
+        bucketStart[(src.hash & (bucketCount - 1)) + 1]++;
+    for (uint64_t b = 0; b < bucketCount; b++)
+        bucketStart[b + 1] += bucketStart[b];
+
+    vector<uint64_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    vector<SnapshotEntry<V>> entries(sources.size());
+    string keyBytes;
+
+    for (const SnapshotSource<V>& src : sources) {
+        SnapshotEntry<V>& entry = entries[fill[src.hash & (bucketCount - 1)]++];
+        memset(&entry, 0, sizeof(entry));
+        entry.hash = src.hash;
+        entry.keyOffset = keyBytes.size();
+        entry.keyLength = src.keyLength;
+        entry.value = *src.value;
+        keyBytes.append(src.keyData, src.keyLength);
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.endianTag = SNAPSHOT_ENDIAN_TAG;
+    header.seed = seed;
+    header.hasherCheck = hasherCheck;
+    header.bucketCount = bucketCount;
+    header.entryCount = entries.size();
+    header.bucketsOffset = alignOffset(sizeof(SnapshotHeader), alignof(uint64_t));
+    header.entriesOffset = alignOffset(header.bucketsOffset + (bucketCount + 1) * sizeof(uint64_t),
+                                       alignof(SnapshotEntry<V>));
+    header.keysOffset = header.entriesOffset + entries.size() * sizeof(SnapshotEntry<V>);
+    header.fileSize = header.keysOffset + keyBytes.size();
+    header.keyIsString = is_same<K, string>::value ? 1 : 0;
+    header.keySize = is_same<K, string>::value ? 0 : (uint32_t)sizeof(K);
+    header.valueSize = (uint32_t)sizeof(V);
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out)
+        return false;
+
+    // Zero padding between sections keeps the file byte-for-byte reproducible
+    auto writeAt = [&out](uint64_t offset, const void* data, size_t bytes) {
+        uint64_t position = (uint64_t)out.tellp();
+        static const char zeros[64] = {0};
+        if (offset > position)
+            out.write(zeros, (streamsize)(offset - position));
+        out.write(static_cast<const char*>(data), (streamsize)bytes);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.bucketsOffset, bucketStart.data(), bucketStart.size() * sizeof(uint64_t));
+    writeAt(header.entriesOffset, entries.data(), entries.size() * sizeof(SnapshotEntry<V>));
+    writeAt(header.keysOffset, keyBytes.data(), keyBytes.size());
+
+    return (bool)out.flush();
+}
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+// getStats() walks the table on demand to build the length histogram, so it
+// costs nothing until called. The per-operation counters (hits, misses,
+// probes, ...) exist only when compiled with -DHASHMAP_STATS; otherwise
+// HASHMAP_COUNT expands to nothing and the counters read as zero.
+
+#ifdef HASHMAP_STATS
+#define HASHMAP_COUNT(statement) statement
+#else
+#define HASHMAP_COUNT(statement)
+#endif
+
+struct HashMapCounters {
+    uint64_t hits = 0;        // search() found the key
+    uint64_t misses = 0;      // search() did not find the key
+    uint64_t inserts = 0;     // New keys added
+    uint64_t updates = 0;     // Existing keys overwritten
+    uint64_t deletes = 0;     // Keys removed
+    uint64_t probes = 0;      // Nodes (HashMap) or groups (FlatHashMap) examined
+    uint64_t rehashes = 0;    // Table resizes / rebuilds
+};
+
+struct HashMapStats {
+    static const int HISTOGRAM_BINS = 16;   // Last bin counts "16 or more"
+
+    const char* lengthKind;       // "chain" (per bucket) or "probe" (per entry, in groups)
+    int size;
+    int capacity;
+    double loadFactor;
+    vector<int> lengthHistogram;  // lengthHistogram[i] = how many have length i
+    int maxLength;
+    double averageLength;         // Over non-empty chains / over entries
+    size_t bytesUsed;             // Table + node / slot storage (not key heap data)
+    bool countersEnabled;
+    HashMapCounters counters;
+
+    HashMapStats()
+        : lengthKind(""), size(0), capacity(0), loadFactor(0), lengthHistogram(HISTOGRAM_BINS, 0),
+          maxLength(0), averageLength(0), bytesUsed(0), countersEnabled(false) {}
+
+    void record(int length) {
+        lengthHistogram[length < HISTOGRAM_BINS ? length : HISTOGRAM_BINS - 1]++;
+        if (length > maxLength)
+            maxLength = length;
+    }
+
+    double hitRatio() const {
+        uint64_t lookups = counters.hits + counters.misses;
+        return lookups != 0 ? (double)counters.hits / lookups : 0.0;
+    }
+
+    void print() const {
+        cout << "Total elements: " << size << "\n";
+        cout << "Capacity: " << capacity << "\n";
+        cout << "Load factor: " << loadFactor << "\n";
+        cout << "Max " << lengthKind << " length: " << maxLength
+             << ", average: " << averageLength << "\n";
+        cout << "Histogram (" << lengthKind << " length:count):";
+        for (int i = 0; i < HISTOGRAM_BINS; i++) {
+            if (lengthHistogram[i] != 0)
+                cout << " " << i << (i == HISTOGRAM_BINS - 1 ? "+" : "") << ":" << lengthHistogram[i];
+        }
+        cout << "\n";
+        cout << "Bytes used: " << bytesUsed << "\n";
+
+        if (countersEnabled) {
+            cout << "Hits: " << counters.hits << ", misses: " << counters.misses
+                 << ", hit ratio: " << hitRatio() << "\n";
+            cout << "Inserts: " << counters.inserts << ", updates: " << counters.updates
+                 << ", deletes: " << counters.deletes << "\n";
+            cout << "Probes: " << counters.probes << ", rehashes: " << counters.rehashes << "\n";
+        }
+        cout << "\n";
+    }
+};
+
+// ============================================================================
+// HASH MAP CLASS
+// ============================================================================
+
+template <typename K, typename V, typename Hasher = DefaultHasher<K>>
 class HashMap {
 private:
     static const int DEFAULT_CAPACITY = 10;
+    static const int REHASH_STEP = 4;              // Buckets migrated per operation
+    static const int BATCH_WINDOW = 32;            // Keys with misses in flight per batch step
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.75;
+
+    // Lookup-only overloads (search / deleteKey with Q != K) exist only for
+    // transparent hashers
+    template <typename Q>
+    using EnableLookup = enable_if_t<IsTransparentHasher<Hasher>::value && !is_same<Q, K>::value>;
+
+    vector<Node<K, V>*> table;     // Array of linked lists
+    int capacity;                  // Size of the hash table
+    int size;                      // Number of key-value pairs
+    double maxLoadFactor;          // Grow once size / capacity exceeds this
+
+    // Incremental rehashing state
+    // While a resize is in progress, entries live in both tables:
+    // buckets [0, migrateIndex) of oldTable have already been moved to table
+    vector<Node<K, V>*> oldTable;  // Table being drained (empty when idle)
+    int oldCapacity;               // Size of oldTable
+    int migrateIndex;              // Next old bucket to migrate
+
+    Hasher hasher;                 // Key -> 64-bit hash
+    uint64_t seed;                 // Per-table random seed
+    NodePool<Node<K, V>> pool;     // Storage for every chain node
+    HashMapCounters counters;      // Only updated with -DHASHMAP_STATS
+
+    // Full 64-bit hash of a key
+    template <typename Q>
+    uint64_t hashOf(const Q& key) {
+        return hasher(key, seed);
+    }
+
+    // Bucket of a hash in a table of the given size
+    static int bucketIndex(uint64_t hash, int buckets) {
+        return (int)(hash % (uint64_t)buckets);
+    }
+
+    // Hash function: converts key to index in a table of the given size
+    template <typename Q>
+    int hashFunction(const Q& key, int buckets) {
+        return bucketIndex(hashOf(key), buckets);
+    }
+
+    bool isRehashing() const {
+        return !oldTable.empty();
+    }
+
+    // Move every node of one old bucket into the new table
+    void migrateBucket(int oldIndex) {
+        Node<K, V>* node = oldTable[oldIndex];
+
+        while (node != nullptr) {
+            Node<K, V>* next = node->next;
+            int index = hashFunction(node->key, capacity);
+            node->next = table[index];
+            table[index] = node;
+            node = next;
+        }
+        oldTable[oldIndex] = nullptr;
+    }
+
+    // Migrate a few buckets; called on every insert/search/delete so the
+    // cost of a resize is spread over many operations. Inserts and deletes
+    // made during the resize were not checked against the load limits, so
+    // the finished table is checked now (and may start the next resize).
+    void rehashStep() {
+        for (int i = 0; i < REHASH_STEP && migrateIndex < oldCapacity; i++)
+            migrateBucket(migrateIndex++);
+
+        if (migrateIndex >= oldCapacity) {
+            finishRehash();
+            maybeGrow();
+            maybeShrink();
+        }
+    }
+
+    // Drain whatever is left of the old table
+    void finishRehash() {
+        while (migrateIndex < oldCapacity)
+            migrateBucket(migrateIndex++);
+
+        vector<Node<K, V>*>().swap(oldTable);
+        oldCapacity = 0;
+        migrateIndex = 0;
+    }
+
+    // Finish the resize in progress and any the load limits then call for
+    void settleRehash() {
+        while (isRehashing()) {
+            finishRehash();
+            maybeGrow();
+            maybeShrink();
+        }
+    }
+
+    // Swap in an empty table of newCapacity buckets; old buckets are moved lazily
+    void startRehash(int newCapacity) {
+        if (isRehashing())
+            finishRehash();
+
+        oldTable.swap(table);
+        oldCapacity = capacity;
+        migrateIndex = 0;
+
+        capacity = newCapacity;
+        table.assign(capacity, nullptr);
+        HASHMAP_COUNT(counters.rehashes++);
+    }
+
+    // Make sure a key is only ever found in the new table: if the old bucket
+    // for its hash has not been migrated yet, move that bucket now. The step
+    // runs first, since finishing one resize can start the next.
+    void prepareKey(uint64_t hash) {
+        if (!isRehashing())
+            return;
+
+        rehashStep();
+        if (!isRehashing())
+            return;
+
+        int oldIndex = bucketIndex(hash, oldCapacity);
+        if (oldIndex >= migrateIndex)
+            migrateBucket(oldIndex);
+    }
+
+    // Grow when the load factor is exceeded
+    void maybeGrow() {
+        if (!isRehashing() && size > maxLoadFactor * capacity)
+            startRehash(capacity * 2);
+    }
+
+    // Shrink when the table is mostly empty (a quarter of the max load)
+    void maybeShrink() {
+        if (!isRehashing() && capacity > DEFAULT_CAPACITY &&
+            size < maxLoadFactor * capacity / 4)
+            startRehash(capacity / 2 > DEFAULT_CAPACITY ? capacity / 2 : DEFAULT_CAPACITY);
+    }
+
+    // Find the node holding key (after migrating its bucket), or nullptr
+    template <typename Q>
+    Node<K, V>* findNode(const Q& key, uint64_t hash) {
+        prepareKey(hash);
+
+        Node<K, V>* node = table[bucketIndex(hash, capacity)];
+
+        // Traverse the linked list at this index
+        while (node != nullptr) {
+            HASHMAP_COUNT(counters.probes++);
+            if (node->key == key)
+                return node;
+            node = node->next;
+        }
+
+        return nullptr;
+    }
+
+    // Link a new node at the head of its chain (hash is the key's hash)
+    template <typename KArg, typename... VArgs>
+    Node<K, V>* addNode(uint64_t hash, KArg&& key, VArgs&&... args) {
+        Node<K, V>* newNode = pool.create(std::forward<KArg>(key), std::forward<VArgs>(args)...);
+        int index = bucketIndex(hash, capacity);
+        newNode->next = table[index];
+        table[index] = newNode;
+        size++;
+        HASHMAP_COUNT(counters.inserts++);
+
+        maybeGrow();
+        return newNode;
+    }
+
+    // Unlink and free key's node; false if it is not present
+    template <typename Q>
+    bool removeNode(const Q& key) {
+        uint64_t hash = hashOf(key);
+        prepareKey(hash);
+
+        int index = bucketIndex(hash, capacity);
+        Node<K, V>* node = table[index];
+        Node<K, V>* prev = nullptr;
+
+        while (node != nullptr) {
+            if (node->key == key) {
+                if (prev == nullptr) {
+                    table[index] = node->next;
+                } else {
+                    prev->next = node->next;
+                }
+                pool.destroy(node);
+                size--;
+                HASHMAP_COUNT(counters.deletes++);
+                maybeShrink();
+                return true;
+            }
+            prev = node;
+            node = node->next;
+        }
+
+        return false;
+    }
+
+public:
+    // Constructor: Initialize hash map
+    explicit HashMap(double maxLoad = DEFAULT_MAX_LOAD_FACTOR)
+        : capacity(DEFAULT_CAPACITY), size(0), maxLoadFactor(maxLoad),
+          oldCapacity(0), migrateIndex(0), seed(randomHashSeed()) {
+        table.resize(capacity, nullptr);
+    }
+
+    HashMap(const HashMap&) = delete;
+    HashMap& operator=(const HashMap&) = delete;
+
+    // Insert or update a key-value pair
+    void insert(K key, V value) {
+        uint64_t hash = hashOf(key);
+        Node<K, V>* node = findNode(key, hash);
+
+        // Check if key already exists (update case)
+        if (node != nullptr) {
+            node->value = std::move(value);
+            HASHMAP_COUNT(counters.updates++);
+            return;
+        }
+
+        // Key doesn't exist, add new node at the beginning
+        addNode(hash, std::move(key), std::move(value));
+    }
+
+    // Construct the value in place from args only if key is absent
+    // Returns the value and whether it was inserted; args are untouched when
+    // the key already exists, so move-only values are never lost
+    template <typename KArg, typename... VArgs>
+    pair<V*, bool> try_emplace(KArg&& key, VArgs&&... args) {
+        uint64_t hash = hashOf(key);
+        Node<K, V>* node = findNode(key, hash);
+        if (node != nullptr)
+            return make_pair(&node->value, false);
+
+        node = addNode(hash, K(std::forward<KArg>(key)), std::forward<VArgs>(args)...);
+        return make_pair(&node->value, true);
+    }
+
+    // Insert, or assign to the existing value; returns true if inserted
+    template <typename KArg, typename M>
+    bool insert_or_assign(KArg&& key, M&& value) {
+        uint64_t hash = hashOf(key);
+        Node<K, V>* node = findNode(key, hash);
+        if (node != nullptr) {
+            node->value = std::forward<M>(value);
+            HASHMAP_COUNT(counters.updates++);
+            return false;
+        }
+
+        addNode(hash, K(std::forward<KArg>(key)), std::forward<M>(value));
+        return true;
+    }
+
+    // Search for a key and return its value
+    V* search(const K& key) {
+        Node<K, V>* node = findNode(key, hashOf(key));
+        HASHMAP_COUNT(node != nullptr ? counters.hits++ : counters.misses++);
+        return node != nullptr ? &(node->value) : nullptr;
+    }
+
+    // Heterogeneous search (e.g. string_view / const char* for string keys)
+    template <typename Q, typename = EnableLookup<Q>>
+    V* search(const Q& key) {
+        Node<K, V>* node = findNode(key, hashOf(key));
+        HASHMAP_COUNT(node != nullptr ? counters.hits++ : counters.misses++);
+        return node != nullptr ? &(node->value) : nullptr;
+    }
+
+    // Look up count keys at once; results[i] = value of keys[i] or nullptr
+    // Each window of keys is processed in three passes so the cache misses of
+    // all keys overlap instead of being paid one after another:
+    //   1. hash every key and prefetch its bucket slot
+    //   2. load every chain head and prefetch the first node
+    //   3. walk the chains (now mostly in cache) and compare keys
+    void search_batch(const K* keys, size_t count, V** results) {
+        int index[BATCH_WINDOW];
+        Node<K, V>* head[BATCH_WINDOW];
+
+        for (size_t base = 0; base < count; base += BATCH_WINDOW) {
+            int n = (int)min((size_t)BATCH_WINDOW, count - base);
+            const K* window = keys + base;
+
+            for (int i = 0; i < n; i++) {
+                uint64_t hash = hashOf(window[i]);
+                prepareKey(hash);
+                index[i] = bucketIndex(hash, capacity);
+                prefetch(&table[index[i]]);
+            }
+
+            for (int i = 0; i < n; i++) {
+                head[i] = table[index[i]];
+                if (head[i] != nullptr)
+                    prefetch(head[i]);
+            }
+
+            for (int i = 0; i < n; i++) {
+                Node<K, V>* node = head[i];
+                while (node != nullptr) {
+                    HASHMAP_COUNT(counters.probes++);
+                    if (node->key == window[i])
+                        break;
+                    node = node->next;
+                }
+                HASHMAP_COUNT(node != nullptr ? counters.hits++ : counters.misses++);
+                results[base + i] = node != nullptr ? &(node->value) : nullptr;
+            }
+        }
+    }
+
+    // Convenience form of search_batch
+    vector<V*> search_batch(const vector<K>& keys) {
+        vector<V*> results(keys.size());
+        search_batch(keys.data(), keys.size(), results.data());
+        return results;
+    }
+
+    // Insert or update count pairs (keys[i] -> values[i]) at once
+    // Hashes and bucket prefetches for a whole window are issued before any
+    // chain is touched; the inserts themselves then run in order
+    void insert_batch(const K* keys, const V* values, size_t count) {
+        uint64_t hash[BATCH_WINDOW];
+
+        for (size_t base = 0; base < count; base += BATCH_WINDOW) {
+            int n = (int)min((size_t)BATCH_WINDOW, count - base);
+
+            for (int i = 0; i < n; i++) {
+                hash[i] = hashOf(keys[base + i]);
+                prefetch(&table[bucketIndex(hash[i], capacity)]);
+            }
+
+            for (int i = 0; i < n; i++) {
+                Node<K, V>* head = table[bucketIndex(hash[i], capacity)];
+                if (head != nullptr)
+                    prefetch(head);
+            }
+
+            for (int i = 0; i < n; i++) {
+                Node<K, V>* node = findNode(keys[base + i], hash[i]);
+                if (node != nullptr) {
+                    node->value = values[base + i];
+                    HASHMAP_COUNT(counters.updates++);
+                } else {
+                    addNode(hash[i], keys[base + i], values[base + i]);
+                }
+            }
+        }
+    }
+
+    // Delete a key-value pair
+    bool deleteKey(const K& key) {
+        return removeNode(key);
+    }
+
+    // Heterogeneous delete (no temporary K is built)
+    template <typename Q, typename = EnableLookup<Q>>
+    bool deleteKey(const Q& key) {
+        return removeNode(key);
+    }
+
+    // Pre-size the table for n entries (done at once, not incrementally)
+    void reserve(int n) {
+        int needed = (int)ceil(n / maxLoadFactor);
+        if (needed <= capacity)
+            return;
+
+        startRehash(needed);
+        finishRehash();
+    }
+
+    // Write every entry to a snapshot file that MappedHashMap can open
+    // (V must be trivially copyable, K a string or trivially copyable)
+    bool saveSnapshot(const string& path) {
+        settleRehash();
+
+        vector<SnapshotSource<V>> sources;
+        sources.reserve(size);
+
+        for (int i = 0; i < capacity; i++) {
+            for (Node<K, V>* node = table[i]; node != nullptr; node = node->next) {
+                string_view bytes = snapshotKeyBytes(node->key);
+                sources.push_back({hashOf(node->key), bytes.data(), bytes.size(), &node->value});
+            }
+        }
+
+        return writeSnapshot<K, V>(path, seed, hasher(K(), seed), sources);
+    }
+
+    // Change the growth threshold; takes effect on the next insert
+    void setMaxLoadFactor(double maxLoad) {
+        maxLoadFactor = maxLoad;
+    }
+
+    // Display all key-value pairs
+    void display() {
+        // Show the settled layout rather than a half-migrated one
+        settleRehash();
+
+        cout << "\n=== Hash Map Contents ===\n";
+        int count = 0;
+
+        for (int i = 0; i < capacity; i++) {
+            Node<K, V>* node = table[i];
+
+            if (node != nullptr) {
+                cout << "Index " << i << ": ";
+
+                // Traverse linked list at this index
+                while (node != nullptr) {
+                    cout << "[" << node->key << " -> " << node->value << "]";
+
+                    if (node->next != nullptr)
+                        cout << " -> ";
+
+                    node = node->next;
+                    count++;
+                }
+                cout << "\n";
+            }
+        }
+
+        getStats().print();
+    }
+
+    // Chain-length histogram, memory use and (with -DHASHMAP_STATS) op counters
+    HashMapStats getStats() const {
+        HashMapStats stats;
+        stats.lengthKind = "chain";
+        stats.size = size;
+        stats.capacity = capacity;
+        stats.loadFactor = (double)size / capacity;
+
+        int nonEmpty = 0;
+        auto walk = [&stats, &nonEmpty](const vector<Node<K, V>*>& buckets) {
+            for (Node<K, V>* node : buckets) {
+                int length = 0;
+                for (; node != nullptr; node = node->next)
+                    length++;
+                stats.record(length);
+                if (length > 0)
+                    nonEmpty++;
+            }
+        };
+        walk(table);
+        walk(oldTable);     // Buckets still waiting to be migrated
+
+        stats.averageLength = nonEmpty != 0 ? (double)size / nonEmpty : 0.0;
+        stats.bytesUsed = sizeof(*this) + (table.capacity() + oldTable.capacity()) * sizeof(Node<K, V>*) +
+                          pool.bytesReserved();
+#ifdef HASHMAP_STATS
+        stats.countersEnabled = true;
+        stats.counters = counters;
+#endif
+        return stats;
+    }
+
+    // Get the size
+    int getSize() {
+        return size;
+    }
+
+    // Get the number of buckets
+    int getCapacity() {
+        return capacity;
+    }
+
+    // Clear the hash map (nodes go back to the pool)
+    void clear() {
+        if (isRehashing())
+            finishRehash();
+
+        for (int i = 0; i < capacity; i++) {
+            Node<K, V>* node = table[i];
+
+            while (node != nullptr) {
+                Node<K, V>* temp = node;
+                node = node->next;
+                pool.destroy(temp);
+            }
+            table[i] = nullptr;
+        }
+        size = 0;
+    }
+
+    // Destructor
+    ~HashMap() {
+        clear();
+    }
+};
+
+// ============================================================================
+// MAPPED HASH MAP (Read-only view of a snapshot file)
+// ============================================================================
+// open() maps the file and validates the header; search() then hashes the key
+// with the seed stored in the file and scans one bucket of the mapped entries,
+// bounds-checking that bucket and each key it reads. Nothing is deserialized,
+// so opening is O(1) regardless of table size, and every process mapping the
+// same file shares one copy in the page cache.
+
+template <typename K, typename V, typename Hasher = DefaultHasher<K>>
+class MappedHashMap {
+private:
+    // Lookup-only overloads exist only for transparent hashers
+    template <typename Q>
+    using EnableLookup = enable_if_t<IsTransparentHasher<Hasher>::value && !is_same<Q, K>::value>;
+
+    const char* base;                  // Start of the mapping (nullptr if closed)
+    size_t mappedSize;
+    bool ownsHeapCopy;                 // Fallback when mmap is unavailable
+
+    const SnapshotHeader* header;
+    const uint64_t* bucketStart;
+    const SnapshotEntry<V>* entries;
+    const char* keyBytes;
+    Hasher hasher;
+
+    // Check every header field before trusting any offset in the file. Only
+    // the header is read, so this is O(1); section sizes are compared by
+    // division against the bytes left so a forged count cannot overflow the
+    // arithmetic. The bucket index and key offsets are checked by find().
+    bool validate() const {
+        if (mappedSize < sizeof(SnapshotHeader))
+            return false;
+        if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0)
+            return false;
+        if (header->version != SNAPSHOT_VERSION || header->endianTag != SNAPSHOT_ENDIAN_TAG)
+            return false;
+        if (header->keyIsString != (is_same<K, string>::value ? 1u : 0u))
+            return false;
+        if (!is_same<K, string>::value && header->keySize != sizeof(K))
+            return false;
+        if (header->valueSize != sizeof(V) || header->fileSize != mappedSize)
+            return false;
+        if (header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0)
+            return false;
+
+        const uint64_t fileSize = header->fileSize;
+        if (header->bucketsOffset < sizeof(SnapshotHeader) || header->bucketsOffset > fileSize ||
+            header->bucketsOffset % alignof(uint64_t) != 0 ||
+            (fileSize - header->bucketsOffset) / sizeof(uint64_t) <= header->bucketCount)
+            return false;
+        uint64_t bucketsEnd = header->bucketsOffset + (header->bucketCount + 1) * sizeof(uint64_t);
+
+        if (header->entriesOffset < bucketsEnd || header->entriesOffset > fileSize ||
+            header->entriesOffset % alignof(SnapshotEntry<V>) != 0 ||
+            (fileSize - header->entriesOffset) / sizeof(SnapshotEntry<V>) < header->entryCount)
+            return false;
+        uint64_t entriesEnd = header->entriesOffset + header->entryCount * sizeof(SnapshotEntry<V>);
+
+        if (header->keysOffset < entriesEnd || header->keysOffset > fileSize)
+            return false;
+        return hasher(K(), header->seed) == header->hasherCheck;
+    }
+
+    template <typename Q>
+    const V* find(const Q& key) const {
+        if (base == nullptr)
+            return nullptr;
+
+        uint64_t hash = hasher(key, header->seed);
+        uint64_t bucket = hash & (header->bucketCount - 1);
+
+        // A corrupt index or key offset reads as a miss, never out of bounds
+        uint64_t first = bucketStart[bucket], last = bucketStart[bucket + 1];
+        if (first > last || last > header->entryCount)
+            return nullptr;
+        const uint64_t keySectionSize = header->fileSize - header->keysOffset;
+
+        for (uint64_t i = first; i < last; i++) {
+            const SnapshotEntry<V>& entry = entries[i];
+            if (entry.hash != hash)
+                continue;
+            if (entry.keyOffset > keySectionSize || entry.keyLength > keySectionSize - entry.keyOffset)
+                continue;
+
+            if constexpr (is_same<K, string>::value) {
+                if (string_view(keyBytes + entry.keyOffset, entry.keyLength) == string_view(key))
+                    return &entry.value;
+            } else {
+                if (entry.keyLength != sizeof(K))
+                    continue;
+                // Decode and compare with ==: raw bytes would miss keys that
+                // differ only in padding, or -0.0 against +0.0
+                K stored;
+                memcpy(&stored, keyBytes + entry.keyOffset, sizeof(K));
+                if (stored == key)
+                    return &entry.value;
+            }
+        }
+
+        return nullptr; // Key not found
+    }
+
+public:
+    MappedHashMap()
+        : base(nullptr), mappedSize(0), ownsHeapCopy(false), header(nullptr),
+          bucketStart(nullptr), entries(nullptr), keyBytes(nullptr) {}
+
+    MappedHashMap(const MappedHashMap&) = delete;
+    MappedHashMap& operator=(const MappedHashMap&) = delete;
+
+    // Map a snapshot file read-only; false if missing, corrupt or incompatible
+    bool open(const string& path) {
+        close();
+
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);    // The mapping keeps the file alive
+        if (mapping == MAP_FAILED)
+            return false;
+
+        base = static_cast<const char*>(mapping);
+        mappedSize = (size_t)info.st_size;
+#else
+        // No mmap: fall back to reading the image into memory
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in)
+            return false;
+        mappedSize = (size_t)in.tellg();
+        char* copy = static_cast<char*>(::operator new(mappedSize));
+        in.seekg(0);
+        in.read(copy, (streamsize)mappedSize);
+        base = copy;
+        ownsHeapCopy = true;
+#endif
+
+        header = reinterpret_cast<const SnapshotHeader*>(base);
+        if (!validate()) {
+            close();
+            return false;
+        }
+
+        bucketStart = reinterpret_cast<const uint64_t*>(base + header->bucketsOffset);
+        entries = reinterpret_cast<const SnapshotEntry<V>*>(base + header->entriesOffset);
+        keyBytes = base + header->keysOffset;
+        return true;
+    }
+
+    // Search for a key; the value lives in the read-only mapping
+    const V* search(const K& key) const {
+        return find(key);
+    }
+
+    // Heterogeneous search (e.g. string_view / const char* for string keys)
+    template <typename Q, typename = EnableLookup<Q>>
+    const V* search(const Q& key) const {
+        return find(key);
+    }
+
+    // Get the size
+    int getSize() const {
+        return base != nullptr ? (int)header->entryCount : 0;
+    }
+
+    bool isOpen() const {
+        return base != nullptr;
+    }
+
+    // Unmap the file
+    void close() {
+        if (base != nullptr) {
+            if (ownsHeapCopy)
+                ::operator delete(const_cast<char*>(base));
+#if defined(__unix__) || defined(__APPLE__)
+            else
+                munmap(const_cast<char*>(base), mappedSize);
+#endif
+        }
+        base = nullptr;
+        mappedSize = 0;
+        ownsHeapCopy = false;
+        header = nullptr;
+        bucketStart = nullptr;
+        entries = nullptr;
+        keyBytes = nullptr;
+    }
+
+    // Destructor
+    ~MappedHashMap() {
+        close();
+    }
+};
+
+// ============================================================================
+// FLAT HASH MAP (Open Addressing, Swiss-table style)
+// ============================================================================
+// Keys and values are stored inline in one flat slot array (no node per entry)
+// A parallel array holds one control byte per slot:
+//   EMPTY   = 0b10000000
+//   DELETED = 0b11111110   (tombstone)
+//   FULL    = 0b0hhhhhhh   (low 7 bits of the hash, "H2")
+// The remaining hash bits ("H1") pick the starting group. A probe compares the
+// control bytes of a whole group against H2 in one SIMD instruction and only
+// touches slots whose tag matches, so most lookups read one cache line of
+// control bytes and exactly one slot.
+
+typedef int8_t ctrl_t;
+
+const ctrl_t CTRL_EMPTY = -128;   // 0x80
+const ctrl_t CTRL_DELETED = -2;   // 0xFE
+
+// Index of the lowest set bit (mask must be non-zero)
+inline int lowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int i = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+// A group of control bytes compared in parallel
+// Each match function returns a bitmask with bit i set if byte i matches
+struct CtrlGroup {
+#if defined(__AVX2__)
+    static const int WIDTH = 32;
+    __m256i ctrl;
+
+    explicit CtrlGroup(const ctrl_t* p)
+        : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+    uint32_t match(ctrl_t h2) const {
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl));
+    }
+
+    uint32_t matchEmpty() const {
+        return match(CTRL_EMPTY);
+    }
+
+    // EMPTY and DELETED are the only bytes with the sign bit set
+    uint32_t matchEmptyOrDeleted() const {
+        return (uint32_t)_mm256_movemask_epi8(ctrl);
+    }
+#elif defined(__SSE2__)
+    static const int WIDTH = 16;
+    __m128i ctrl;
+
+    explicit CtrlGroup(const ctrl_t* p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    uint32_t match(ctrl_t h2) const {
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+    }
+
+    uint32_t matchEmpty() const {
+        return match(CTRL_EMPTY);
+    }
+
+    // EMPTY and DELETED are the only bytes with the sign bit set
+    uint32_t matchEmptyOrDeleted() const {
+        return (uint32_t)_mm_movemask_epi8(ctrl);
+    }
+#else
+    // Portable fallback: same semantics, one byte at a time
+    static const int WIDTH = 16;
+    const ctrl_t* ctrl;
+
+    explicit CtrlGroup(const ctrl_t* p) : ctrl(p) {}
+
+    uint32_t match(ctrl_t h2) const {
+        uint32_t mask = 0;
+        for (int i = 0; i < WIDTH; i++) {
+            if (ctrl[i] == h2)
+                mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    uint32_t matchEmpty() const {
+        return match(CTRL_EMPTY);
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        uint32_t mask = 0;
+        for (int i = 0; i < WIDTH; i++) {
+            if (ctrl[i] < 0)
+                mask |= 1u << i;
+        }
+        return mask;
+    }
+#endif
+};
+
+template <typename K, typename V, typename Hasher = DefaultHasher<K>>
+class FlatHashMap {
+private:
+    typedef pair<K, V> Slot;
+
+    static const size_t GROUP_WIDTH = CtrlGroup::WIDTH;
+    static const size_t NOT_FOUND = (size_t)-1;
+
+    ctrl_t* ctrl;       // capacity + GROUP_WIDTH control bytes (tail mirrors head)
+    Slot* slots;        // capacity slots, constructed only where ctrl is FULL
+    size_t capacity;    // Always a power of two and >= GROUP_WIDTH
+    size_t size;        // Number of FULL slots
+    size_t deleted;     // Number of DELETED (tombstone) slots
+
+    Hasher hasher;      // Key -> 64-bit hash (split into H1 / H2)
+    uint64_t seed;      // Per-table random seed
+    mutable HashMapCounters counters;   // Only updated with -DHASHMAP_STATS
+
+    uint64_t hashFunction(const K& key) const {
+        return hasher(key, seed);
+    }
+
+    static size_t h1(uint64_t hash) { return (size_t)(hash >> 7); }
+    static ctrl_t h2(uint64_t hash) { return (ctrl_t)(hash & 0x7F); }
+
+    // Maximum number of FULL + DELETED slots before we must grow (7/8 load)
+    static size_t growthLimit(size_t cap) {
+        return cap - cap / 8;
+    }
+
+    // Write a control byte, keeping the mirrored tail in sync so a group
+    // load starting near the end of the table never has to wrap around
+    void setCtrl(size_t index, ctrl_t value) {
+        ctrl[index] = value;
+        if (index < GROUP_WIDTH)
+            ctrl[capacity + index] = value;
+    }
+
+    void allocate(size_t cap) {
+        capacity = cap;
+        ctrl = new ctrl_t[capacity + GROUP_WIDTH];
+        memset(ctrl, (unsigned char)CTRL_EMPTY, capacity + GROUP_WIDTH);
+        slots = static_cast<Slot*>(::operator new(capacity * sizeof(Slot)));
+        size = 0;
+        deleted = 0;
+    }
+
+    // Find the slot holding key, or NOT_FOUND
+    size_t findIndex(const K& key, uint64_t hash) const {
+        size_t mask = capacity - 1;
+        size_t pos = h1(hash) & mask;
+        size_t step = 0;
+
+        while (true) {
+            CtrlGroup group(ctrl + pos);
+            HASHMAP_COUNT(counters.probes++);
+
+            // Only compare keys whose 7-bit tag matches
+            uint32_t candidates = group.match(h2(hash));
+            while (candidates != 0) {
+                size_t index = (pos + lowestBit(candidates)) & mask;
+                if (slots[index].first == key)
+                    return index;
+                candidates &= candidates - 1;
+            }
+
+            // An EMPTY byte ends the probe sequence: the key was never placed further
+            if (group.matchEmpty() != 0)
+                return NOT_FOUND;
+
+            // Triangular probing over groups visits every group exactly once
+            step += GROUP_WIDTH;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // First EMPTY or DELETED slot on the probe sequence of hash
+    size_t findInsertIndex(uint64_t hash) const {
+        size_t mask = capacity - 1;
+        size_t pos = h1(hash) & mask;
+        size_t step = 0;
+
+        while (true) {
+            uint32_t free = CtrlGroup(ctrl + pos).matchEmptyOrDeleted();
+            if (free != 0)
+                return (pos + lowestBit(free)) & mask;
+
+            step += GROUP_WIDTH;
+            pos = (pos + step) & mask;
+        }
+    }
 
-    vector<Node<K, V>*> table;     // Array of linked lists
-    int capacity;                  // Size of the hash table
-    int size;                      // Number of key-value pairs
+    // Move every entry into a fresh table of newCapacity slots
+    // (same capacity is used to purge tombstones)
+    void rehash(size_t newCapacity) {
+        ctrl_t* oldCtrl = ctrl;
+        Slot* oldSlots = slots;
+        size_t oldCapacity = capacity;
 
-    // Hash function: converts key to index
-    int hashFunction(K key) {
-        // Simple hash function using modulo
-        // For string, use sum of ASCII values
-        int hashCode = 0;
+        allocate(newCapacity);
+        HASHMAP_COUNT(counters.rehashes++);
 
-        if (is_same<K, string>::value) {
-            string s = reinterpret_cast<string&>(key);
-            for (char c : s) {
-                hashCode += (int)c;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] >= 0) {
+                uint64_t hash = hashFunction(oldSlots[i].first);
+                size_t index = findInsertIndex(hash);
+                new (&slots[index]) Slot(std::move(oldSlots[i]));
+                setCtrl(index, h2(hash));
+                size++;
+                oldSlots[i].~Slot();
             }
-        } else {
-            // For numeric types
-            hashCode = (int)key;
         }
 
-        return abs(hashCode) % capacity;
+        delete[] oldCtrl;
+        ::operator delete(oldSlots);
+    }
+
+    // Make room for one more entry
+    void reserveOne() {
+        if (size + deleted + 1 <= growthLimit(capacity))
+            return;
+
+        // Mostly tombstones: clean up in place instead of doubling
+        if (deleted > size / 2)
+            rehash(capacity);
+        else
+            rehash(capacity * 2);
+    }
+
+    void destroySlots() {
+        for (size_t i = 0; i < capacity; i++) {
+            if (ctrl[i] >= 0)
+                slots[i].~Slot();
+        }
     }
 
 public:
-    // Constructor: Initialize hash map
-    HashMap() : capacity(DEFAULT_CAPACITY), size(0) {
-        table.resize(capacity, nullptr);
+    // Constructor: start with one group of empty slots
+    FlatHashMap() : seed(randomHashSeed()) {
+        allocate(GROUP_WIDTH);
     }
 
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
     // Insert or update a key-value pair
     void insert(K key, V value) {
-        int index = hashFunction(key);
-        Node<K, V>* node = table[index];
+        uint64_t hash = hashFunction(key);
+        size_t index = findIndex(key, hash);
 
-        // Check if key already exists (update case)
-        while (node != nullptr) {
-            if (node->key == key) {
-                node->value = value;
-                cout << "Updated key: " << key << " with value: " << value << "\n";
-                return;
-            }
-            node = node->next;
+        // Key already exists (update case)
+        if (index != NOT_FOUND) {
+            slots[index].second = std::move(value);
+            HASHMAP_COUNT(counters.updates++);
+            return;
         }
 
-        // Key doesn't exist, add new node at the beginning
-        Node<K, V>* newNode = new Node<K, V>(key, value);
-        newNode->next = table[index];
-        table[index] = newNode;
-        size++;
+        reserveOne();
 
-        cout << "Inserted: " << key << " -> " << value << "\n";
+        index = findInsertIndex(hash);
+        if (ctrl[index] == CTRL_DELETED)
+            deleted--;
+
+        new (&slots[index]) Slot(std::move(key), std::move(value));
+        setCtrl(index, h2(hash));
+        size++;
+        HASHMAP_COUNT(counters.inserts++);
     }
 
     // Search for a key and return its value
     V* search(K key) {
-        int index = hashFunction(key);
-        Node<K, V>* node = table[index];
+        size_t index = findIndex(key, hashFunction(key));
+        HASHMAP_COUNT(index != NOT_FOUND ? counters.hits++ : counters.misses++);
+        if (index == NOT_FOUND)
+            return nullptr; // Key not found
+        return &(slots[index].second);
+    }
 
-        // Traverse the linked list at this index
+    // Delete a key-value pair (leaves a tombstone so later probes continue)
+    bool deleteKey(K key) {
+        size_t index = findIndex(key, hashFunction(key));
+        if (index == NOT_FOUND)
+            return false;
+
+        slots[index].~Slot();
+        setCtrl(index, CTRL_DELETED);
+        size--;
+        deleted++;
+        HASHMAP_COUNT(counters.deletes++);
+        return true;
+    }
+
+    // Display all key-value pairs
+    void display() {
+        cout << "\n=== Flat Hash Map Contents ===\n";
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (ctrl[i] >= 0) {
+                cout << "Slot " << i << ": [" << slots[i].first
+                     << " -> " << slots[i].second << "]\n";
+            }
+        }
+
+        cout << "Group width: " << GROUP_WIDTH << "\n";
+        getStats().print();
+    }
+
+    // Probe-length histogram (groups visited to reach each entry), memory use
+    // and (with -DHASHMAP_STATS) op counters
+    HashMapStats getStats() const {
+        HashMapStats stats;
+        stats.lengthKind = "probe";
+        stats.size = (int)size;
+        stats.capacity = (int)capacity;
+        stats.loadFactor = (double)size / capacity;
+
+        size_t mask = capacity - 1;
+        uint64_t totalLength = 0;
+
+        for (size_t i = 0; i < capacity; i++) {
+            if (ctrl[i] < 0)
+                continue;
+
+            // Replay the probe sequence until the group that covers slot i
+            size_t pos = h1(hashFunction(slots[i].first)) & mask;
+            size_t step = 0;
+            int length = 1;
+            while (((i - pos) & mask) >= GROUP_WIDTH) {
+                step += GROUP_WIDTH;
+                pos = (pos + step) & mask;
+                length++;
+            }
+
+            stats.record(length);
+            totalLength += length;
+        }
+
+        stats.averageLength = size != 0 ? (double)totalLength / size : 0.0;
+        stats.bytesUsed = sizeof(*this) + capacity + GROUP_WIDTH + capacity * sizeof(Slot);
+#ifdef HASHMAP_STATS
+        stats.countersEnabled = true;
+        stats.counters = counters;
+#endif
+        return stats;
+    }
+
+    // Get the size
+    int getSize() {
+        return (int)size;
+    }
+
+    // Clear the flat hash map (keeps the current capacity)
+    void clear() {
+        destroySlots();
+        memset(ctrl, (unsigned char)CTRL_EMPTY, capacity + GROUP_WIDTH);
+        size = 0;
+        deleted = 0;
+    }
+
+    // Destructor
+    ~FlatHashMap() {
+        destroySlots();
+        delete[] ctrl;
+        ::operator delete(slots);
+    }
+};
+
+// ============================================================================
+// EPOCH-BASED RECLAMATION
+// ============================================================================
+// Lets readers walk shared nodes without taking a lock:
+// - A reader announces the current global epoch before touching any node
+//   and clears the announcement when done
+// - A writer that unlinks a node tags it with the global epoch at that time
+//   instead of deleting it
+// - A tagged node is freed only once every active reader announced a later
+//   epoch, i.e. no reader can still hold a pointer to it
+
+class EpochDomain {
+private:
+    static const int MAX_THREADS = 512;
+    static const uint64_t IDLE = UINT64_MAX;
+
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch;  // Announced epoch, IDLE when not reading
+        atomic<bool> inUse;      // Owned by a live thread
+    };
+
+    atomic<uint64_t> globalEpoch;
+    ReaderSlot slots[MAX_THREADS];
+
+    EpochDomain() : globalEpoch(1) {
+        for (int i = 0; i < MAX_THREADS; i++) {
+            slots[i].epoch.store(IDLE);
+            slots[i].inUse.store(false);
+        }
+    }
+
+    int acquireSlot() {
+        for (int i = 0; i < MAX_THREADS; i++) {
+            bool expected = false;
+            if (!slots[i].inUse.load(memory_order_relaxed) &&
+                slots[i].inUse.compare_exchange_strong(expected, true))
+                return i;
+        }
+        throw runtime_error("EpochDomain: too many reader threads");
+    }
+
+    void releaseSlot(int index) {
+        slots[index].epoch.store(IDLE);
+        slots[index].inUse.store(false);
+    }
+
+    // One slot per thread, returned when the thread exits
+    struct ThreadSlot {
+        int index;
+        ThreadSlot() : index(instance().acquireSlot()) {}
+        ~ThreadSlot() { instance().releaseSlot(index); }
+    };
+
+    static int mySlot() {
+        static thread_local ThreadSlot slot;
+        return slot.index;
+    }
+
+public:
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    // RAII read-side critical section
+    class Guard {
+    private:
+        ReaderSlot& slot;
+
+    public:
+        Guard() : slot(instance().slots[mySlot()]) {
+            slot.epoch.store(instance().globalEpoch.load());
+            // The announcement must be visible before we load any shared pointer
+            atomic_thread_fence(memory_order_seq_cst);
+        }
+
+        ~Guard() {
+            slot.epoch.store(IDLE, memory_order_release);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // Tag for something unlinked right now
+    uint64_t retireEpoch() {
+        atomic_thread_fence(memory_order_seq_cst);
+        return globalEpoch.load();
+    }
+
+    // Start a new epoch and return the oldest epoch any reader may still be in;
+    // everything retired before it is safe to free
+    uint64_t advance() {
+        uint64_t oldest = globalEpoch.fetch_add(1) + 1;
+        atomic_thread_fence(memory_order_seq_cst);
+
+        for (int i = 0; i < MAX_THREADS; i++) {
+            uint64_t e = slots[i].epoch.load();
+            if (e < oldest)
+                oldest = e;
+        }
+        return oldest;
+    }
+};
+
+// ============================================================================
+// CONCURRENT HASH MAP (Sharded, lock-free reads)
+// ============================================================================
+// The top bits of the hash pick one of N shards; each shard is a chained
+// table with its own mutex, so writers only contend within a shard.
+// Nodes are never modified after they are published: an update links in a
+// replacement node, and unlinked nodes / old bucket arrays are retired to the
+// EpochDomain. search() therefore walks the chains without any lock.
+
+template <typename K, typename V, typename Hasher = DefaultHasher<K>>
+class ConcurrentHashMap {
+private:
+    static const size_t INITIAL_BUCKETS = 16;     // Per shard, power of two
+    static const size_t RECLAIM_THRESHOLD = 64;   // Retired items before a reclaim pass
+
+    struct CNode {
+        const K key;
+        const V value;
+        atomic<CNode*> next;
+
+        CNode(const K& k, const V& v, CNode* n) : key(k), value(v), next(n) {}
+    };
+
+    struct BucketArray {
+        size_t capacity;                // Power of two
+        atomic<CNode*>* buckets;
+
+        explicit BucketArray(size_t cap) : capacity(cap), buckets(new atomic<CNode*>[cap]) {
+            for (size_t i = 0; i < cap; i++)
+                buckets[i].store(nullptr, memory_order_relaxed);
+        }
+
+        ~BucketArray() {
+            delete[] buckets;
+        }
+    };
+
+    // Something unlinked but possibly still visible to a reader
+    struct Retired {
+        uint64_t epoch;
+        CNode* node;
+        BucketArray* array;
+    };
+
+    struct alignas(64) Shard {
+        mutex lock;                     // Taken by insert / deleteKey only
+        atomic<BucketArray*> array;
+        atomic<size_t> size;
+        vector<Retired> retired;        // Guarded by lock
+
+        Shard() : array(new BucketArray(INITIAL_BUCKETS)), size(0) {}
+    };
+
+    Shard* shards;
+    int shardCount;                     // Power of two
+    int shardShift;                     // 64 - log2(shardCount)
+    Hasher hasher;
+    uint64_t seed;
+
+    Shard& shardFor(uint64_t hash) const {
+        return shards[shardShift == 64 ? 0 : (hash >> shardShift)];
+    }
+
+    static size_t bucketFor(uint64_t hash, const BucketArray* array) {
+        return (size_t)hash & (array->capacity - 1);
+    }
+
+    void retire(Shard& shard, CNode* node, BucketArray* array) {
+        shard.retired.push_back({EpochDomain::instance().retireEpoch(), node, array});
+
+        if (shard.retired.size() >= RECLAIM_THRESHOLD)
+            reclaim(shard);
+    }
+
+    // Free everything no reader can still see (caller holds shard.lock)
+    void reclaim(Shard& shard) {
+        uint64_t safe = EpochDomain::instance().advance();
+        size_t kept = 0;
+
+        for (size_t i = 0; i < shard.retired.size(); i++) {
+            Retired& r = shard.retired[i];
+            if (r.epoch < safe) {
+                delete r.node;
+                delete r.array;
+            } else {
+                shard.retired[kept++] = r;
+            }
+        }
+        shard.retired.resize(kept);
+    }
+
+    // Double a shard's bucket array (caller holds shard.lock)
+    // Readers may be walking the old chains, so the nodes are copied rather
+    // than relinked, and the old array and nodes are retired as a whole
+    void growShard(Shard& shard) {
+        BucketArray* oldArray = shard.array.load(memory_order_relaxed);
+        BucketArray* newArray = new BucketArray(oldArray->capacity * 2);
+
+        for (size_t i = 0; i < oldArray->capacity; i++) {
+            CNode* node = oldArray->buckets[i].load(memory_order_relaxed);
+            while (node != nullptr) {
+                size_t index = bucketFor(hasher(node->key, seed), newArray);
+                CNode* head = newArray->buckets[index].load(memory_order_relaxed);
+                newArray->buckets[index].store(new CNode(node->key, node->value, head),
+                                               memory_order_relaxed);
+                node = node->next.load(memory_order_relaxed);
+            }
+        }
+
+        shard.array.store(newArray, memory_order_release);
+
+        for (size_t i = 0; i < oldArray->capacity; i++) {
+            CNode* node = oldArray->buckets[i].load(memory_order_relaxed);
+            while (node != nullptr) {
+                CNode* next = node->next.load(memory_order_relaxed);
+                retire(shard, node, nullptr);
+                node = next;
+            }
+        }
+        retire(shard, nullptr, oldArray);
+    }
+
+public:
+    // Constructor: shards = 0 picks 4 shards per hardware thread
+    explicit ConcurrentHashMap(int shards = 0) : seed(randomHashSeed()) {
+        if (shards <= 0)
+            shards = 4 * (int)max(1u, thread::hardware_concurrency());
+
+        shardCount = 1;
+        shardShift = 64;
+        while (shardCount < shards) {
+            shardCount *= 2;
+            shardShift--;
+        }
+
+        this->shards = new Shard[shardCount];
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    // Insert or update a key-value pair (locks one shard)
+    void insert(const K& key, const V& value) {
+        uint64_t hash = hasher(key, seed);
+        Shard& shard = shardFor(hash);
+        lock_guard<mutex> guard(shard.lock);
+
+        BucketArray* array = shard.array.load(memory_order_relaxed);
+        atomic<CNode*>* link = &array->buckets[bucketFor(hash, array)];
+        CNode* node = link->load(memory_order_relaxed);
+
+        // Update case: swap in a replacement node
         while (node != nullptr) {
             if (node->key == key) {
-                return &(node->value);
+                CNode* next = node->next.load(memory_order_relaxed);
+                link->store(new CNode(key, value, next), memory_order_release);
+                retire(shard, node, nullptr);
+                return;
             }
-            node = node->next;
+            link = &node->next;
+            node = link->load(memory_order_relaxed);
         }
 
-        return nullptr; // Key not found
+        // New key: publish at the head of the chain
+        atomic<CNode*>& head = array->buckets[bucketFor(hash, array)];
+        head.store(new CNode(key, value, head.load(memory_order_relaxed)), memory_order_release);
+
+        size_t count = shard.size.fetch_add(1, memory_order_relaxed) + 1;
+        if (count > array->capacity)
+            growShard(shard);
     }
 
-    // Delete a key-value pair
-    bool deleteKey(K key) {
-        int index = hashFunction(key);
-        Node<K, V>* node = table[index];
-        Node<K, V>* prev = nullptr;
+    // Search for a key and copy out its value (never blocks)
+    bool search(const K& key, V& value) const {
+        uint64_t hash = hasher(key, seed);
+        const Shard& shard = shardFor(hash);
+        EpochDomain::Guard guard;
+
+        const BucketArray* array = shard.array.load(memory_order_acquire);
+        CNode* node = array->buckets[bucketFor(hash, array)].load(memory_order_acquire);
 
-        // Find and delete the node
         while (node != nullptr) {
             if (node->key == key) {
-                if (prev == nullptr) {
-                    table[index] = node->next;
-                } else {
-                    prev->next = node->next;
-                }
-                delete node;
-                size--;
-                cout << "Deleted key: " << key << "\n";
+                value = node->value;
                 return true;
             }
-            prev = node;
-            node = node->next;
+            node = node->next.load(memory_order_acquire);
         }
 
-        cout << "Key not found: " << key << "\n";
-        return false;
+        return false; // Key not found
     }
 
-    // Display all key-value pairs
-    void display() {
-        cout << "\n=== Hash Map Contents ===\n";
-        int count = 0;
-
-        for (int i = 0; i < capacity; i++) {
-            Node<K, V>* node = table[i];
-
-            if (node != nullptr) {
-                cout << "Index " << i << ": ";
+    // Check whether a key is present (never blocks)
+    bool contains(const K& key) const {
+        V ignored;
+        return search(key, ignored);
+    }
 
-                // Traverse linked list at this index
-                while (node != nullptr) {
-                    cout << "[" << node->key << " -> " << node->value << "]";
+    // Delete a key-value pair (locks one shard)
+    bool deleteKey(const K& key) {
+        uint64_t hash = hasher(key, seed);
+        Shard& shard = shardFor(hash);
+        lock_guard<mutex> guard(shard.lock);
 
-                    if (node->next != nullptr)
-                        cout << " -> ";
+        BucketArray* array = shard.array.load(memory_order_relaxed);
+        atomic<CNode*>* link = &array->buckets[bucketFor(hash, array)];
+        CNode* node = link->load(memory_order_relaxed);
 
-                    node = node->next;
-                    count++;
-                }
-                cout << "\n";
+        while (node != nullptr) {
+            if (node->key == key) {
+                // Readers already on this node still see a valid next pointer
+                link->store(node->next.load(memory_order_relaxed), memory_order_release);
+                shard.size.fetch_sub(1, memory_order_relaxed);
+                retire(shard, node, nullptr);
+                return true;
             }
+            link = &node->next;
+            node = link->load(memory_order_relaxed);
         }
 
-        cout << "Total elements: " << size << "\n";
-        cout << "Load factor: " << (double)size / capacity << "\n\n";
+        return false;
     }
 
-    // Get the size
-    int getSize() {
-        return size;
+    // Get the size (a snapshot; may be stale under concurrent writes)
+    int getSize() const {
+        size_t total = 0;
+        for (int i = 0; i < shardCount; i++)
+            total += shards[i].size.load(memory_order_relaxed);
+        return (int)total;
     }
 
-    // Clear the hash map
-    void clear() {
-        for (int i = 0; i < capacity; i++) {
-            Node<K, V>* node = table[i];
+    // Get the number of shards
+    int getShardCount() const {
+        return shardCount;
+    }
 
-            while (node != nullptr) {
-                Node<K, V>* temp = node;
-                node = node->next;
-                delete temp;
+    // Destructor (no other thread may be using the map)
+    ~ConcurrentHashMap() {
+        for (int s = 0; s < shardCount; s++) {
+            Shard& shard = shards[s];
+            BucketArray* array = shard.array.load();
+
+            for (size_t i = 0; i < array->capacity; i++) {
+                CNode* node = array->buckets[i].load();
+                while (node != nullptr) {
+                    CNode* next = node->next.load();
+                    delete node;
+                    node = next;
+                }
             }
-            table[i] = nullptr;
-        }
-        size = 0;
-        cout << "Hash map cleared!\n\n";
-    }
+            delete array;
 
-    // Destructor
-    ~HashMap() {
-        clear();
+            for (const Retired& r : shard.retired) {
+                delete r.node;
+                delete r.array;
+            }
+        }
+        delete[] shards;
     }
 };
 
@@ -203,9 +1966,9 @@ int main() {
 
     map1.insert(1, 100);
     map1.insert(2, 200);
-    map1.insert(11, 1100);  // Will collide with 1 (same hash index)
+    map1.insert(11, 1100);
     map1.insert(3, 300);
-    map1.insert(13, 1300);  // Will collide with 3
+    map1.insert(13, 1300);
     map1.insert(5, 500);
 
     map1.display();
@@ -220,6 +1983,10 @@ int main() {
     map1.deleteKey(2);
     map1.display();
 
+    // Statistics without printing the contents
+    HashMapStats stats1 = map1.getStats();
+    cout << "Longest chain: " << stats1.maxLength << ", bytes used: " << stats1.bytesUsed << "\n";
+
     cout << "\n";
 
     // Test case 2: String keys with String values
@@ -273,5 +2040,191 @@ int main() {
     map3.insert("Grape", 65);  // Update existing key
     map3.display();
 
+    cout << "\n";
+
+    // Test case 4: Flat (open addressing) engine, same interface
+    cout << "Test 4: Flat Hash Map (open addressing, group probing)\n";
+    cout << "=====================================================\n";
+
+    FlatHashMap<string, int> map4;
+
+    map4.insert("Apple", 50);
+    map4.insert("Banana", 30);
+    map4.insert("Orange", 40);
+    map4.insert("Grape", 60);
+    map4.insert("Mango", 45);
+
+    map4.deleteKey("Banana");
+    map4.insert("Grape", 65);  // Update existing key
+    map4.display();
+
+    cout << "Searching for key 'Grape': ";
+    int* result4 = map4.search("Grape");
+    if (result4 != nullptr)
+        cout << "Found! Value = " << *result4 << "\n";
+    else
+        cout << "Not found!\n";
+
+    cout << "Searching for key 'Banana': "
+         << (map4.search("Banana") != nullptr ? "Found!" : "Not found!") << "\n\n";
+
+    // Grow well past the initial group and churn with deletes
+    FlatHashMap<int, int> map5;
+    for (int i = 0; i < 10000; i++)
+        map5.insert(i, i * i);
+    for (int i = 0; i < 10000; i += 2)
+        map5.deleteKey(i);
+
+    bool allCorrect = true;
+    for (int i = 0; i < 10000; i++) {
+        int* value = map5.search(i);
+        if (i % 2 == 0 ? value != nullptr : (value == nullptr || *value != i * i))
+            allCorrect = false;
+    }
+    cout << "Flat map after 10000 inserts / 5000 deletes: size = " << map5.getSize()
+         << ", lookups correct? " << (allCorrect ? "Yes" : "No") << "\n\n";
+
+    // Test case 5: Chained map grows and shrinks incrementally
+    cout << "Test 5: Incremental rehashing\n";
+    cout << "=============================\n";
+
+    HashMap<int, int> map6(1.0);   // max load factor 1.0
+    for (int i = 0; i < 50; i++)
+        map6.insert(i, i * 10);
+    cout << "After 50 inserts: capacity = " << map6.getCapacity() << "\n";
+
+    for (int i = 0; i < 45; i++)
+        map6.deleteKey(i);
+    map6.display();
+
+    HashMap<int, int> map7;
+    map7.reserve(1000);
+    cout << "Reserved for 1000 entries: capacity = " << map7.getCapacity() << "\n\n";
+
+    // Test case 6: Concurrent map, readers run while writers update
+    cout << "Test 6: Concurrent Hash Map (sharded, lock-free reads)\n";
+    cout << "======================================================\n";
+
+    ConcurrentHashMap<int, int> map8(8);
+    const int KEYS = 20000;
+    atomic<bool> readersOk(true);
+
+    vector<thread> workers;
+    for (int w = 0; w < 2; w++) {
+        // Writers: each owns half the keys, inserts, updates, deletes some
+        workers.emplace_back([&map8, w]() {
+            for (int i = w; i < KEYS; i += 2)
+                map8.insert(i, i);
+            for (int i = w; i < KEYS; i += 2)
+                map8.insert(i, i * 2);
+            for (int i = w; i < KEYS; i += 6)
+                map8.deleteKey(i);
+        });
+    }
+    for (int r = 0; r < 2; r++) {
+        // Readers: any value seen must be one a writer stored for that key
+        workers.emplace_back([&map8, &readersOk]() {
+            for (int round = 0; round < 3; round++) {
+                for (int i = 0; i < KEYS; i++) {
+                    int value;
+                    if (map8.search(i, value) && value != i && value != i * 2)
+                        readersOk = false;
+                }
+            }
+        });
+    }
+    for (thread& t : workers)
+        t.join();
+
+    bool finalOk = true;
+    for (int i = 0; i < KEYS; i++) {
+        int value;
+        bool found = map8.search(i, value);
+        bool removed = (i % 2 == 0) ? (i % 6 == 0) : ((i - 1) % 6 == 0);
+        if (found == removed || (found && value != i * 2))
+            finalOk = false;
+    }
+    cout << "Shards: " << map8.getShardCount() << ", size: " << map8.getSize() << "\n";
+    cout << "Readers saw consistent values? " << (readersOk ? "Yes" : "No") << "\n";
+    cout << "Final contents correct? " << (finalOk ? "Yes" : "No") << "\n\n";
+
+    // Test case 7: Emplace / move-only values / string_view lookup
+    cout << "Test 7: try_emplace, insert_or_assign, heterogeneous lookup\n";
+    cout << "===========================================================\n";
+
+    HashMap<string, unique_ptr<string>> map9;
+
+    map9.try_emplace("Alice", make_unique<string>("Engineer"));
+    map9.try_emplace(string("Bob"), make_unique<string>("Designer"));
+    bool inserted = map9.try_emplace("Alice", make_unique<string>("Ignored")).second;
+    map9.insert_or_assign(string_view("Bob"), make_unique<string>("Lead Designer"));
+
+    string_view who = "Bob";
+    unique_ptr<string>* role = map9.search(who);
+    cout << "Second try_emplace of 'Alice' inserted? " << (inserted ? "Yes" : "No") << "\n";
+    cout << "Search by string_view 'Bob': " << (role ? **role : string("Not found")) << "\n";
+    cout << "Search by const char* 'Alice': " << **map9.search("Alice") << "\n";
+    cout << "Delete by const char* 'Bob': " << (map9.deleteKey("Bob") ? "Deleted" : "Not found") << "\n";
+    cout << "Size: " << map9.getSize() << "\n\n";
+
+    // Test case 8: Batched, prefetch-pipelined lookups
+    cout << "Test 8: search_batch / insert_batch\n";
+    cout << "===================================\n";
+
+    HashMap<int, int> map10;
+    vector<int> batchKeys, batchValues;
+    for (int i = 0; i < 5000; i++) {
+        batchKeys.push_back(i * 7);
+        batchValues.push_back(i);
+    }
+    map10.insert_batch(batchKeys.data(), batchValues.data(), batchKeys.size());
+
+    vector<int> probes;
+    for (int i = 0; i < 10000; i++)
+        probes.push_back(i * 7 / 2);    // Every other probe is a hit
+    vector<int*> found = map10.search_batch(probes);
+
+    bool batchOk = true;
+    for (size_t i = 0; i < probes.size(); i++) {
+        int* single = map10.search(probes[i]);
+        if (found[i] != single)
+            batchOk = false;
+    }
+    cout << "Inserted " << map10.getSize() << " keys in batches\n";
+    cout << "Batch results match single lookups? " << (batchOk ? "Yes" : "No") << "\n\n";
+
+    // Test case 9: Snapshot to disk, reopen through mmap
+    cout << "Test 9: Memory-mapped snapshot\n";
+    cout << "==============================\n";
+
+    HashMap<string, int> map11;
+    for (int i = 0; i < 1000; i++)
+        map11.insert_or_assign("key" + to_string(i), i * 3);
+
+    const string snapshotPath = "hash_map_snapshot.bin";
+    bool saved = map11.saveSnapshot(snapshotPath);
+
+    MappedHashMap<string, int> mapped;
+    bool opened = saved && mapped.open(snapshotPath);
+
+    bool mappedOk = opened && mapped.getSize() == map11.getSize();
+    for (int i = 0; i < 1000 && mappedOk; i++) {
+        const int* value = mapped.search("key" + to_string(i));
+        if (value == nullptr || *value != i * 3)
+            mappedOk = false;
+    }
+    if (opened && mapped.search(string_view("missing")) != nullptr)
+        mappedOk = false;
+
+    MappedHashMap<int, int> wrongType;
+    cout << "Snapshot saved? " << (saved ? "Yes" : "No") << "\n";
+    cout << "Mapped " << mapped.getSize() << " entries, lookups correct? "
+         << (mappedOk ? "Yes" : "No") << "\n";
+    cout << "Opening with the wrong key type rejected? "
+         << (!wrongType.open(snapshotPath) ? "Yes" : "No") << "\n";
+
+    mapped.close();
+    remove(snapshotPath.c_str());
+
     return 0;
 }
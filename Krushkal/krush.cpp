@@ -7,10 +7,42 @@
 // Uses Union-Find (Disjoint Set Union) data structure
 // Time Complexity: O(E log E) for sorting edges
 // Space Complexity: O(V)
+//
+// kruskalMST orders integer weights with a linear-time radix sort
+// filterKruskalMST skips most of the sort: it partitions edges around a
+// random pivot weight, solves the light side first, then throws away heavy
+// edges whose ends are already connected before recursing on the rest
+// (close to O(E) on dense graphs)
+// boruvkaMST: in each round every component picks its lightest outgoing
+// edge (edges scanned by all threads at once), the picks are merged, and
+// edges inside one component are dropped; O(E log V) work over at most
+// log2(V) rounds
+// externalKruskalMST reads edges from a file larger than memory: sorted
+// runs are spilled to a temporary file and merged k ways (in one pass unless
+// the merge blocks would get too small) straight into the union-find, which
+// is the only O(V) structure kept in memory
+// primMST (indexed 4-ary heap over a CSR adjacency, O(E log V)) and
+// densePrimMST (array scan, O(V^2)) are the Prim engines; adaptiveMST
+// picks Kruskal, heap Prim or dense Prim from the edge density and layout
+// DynamicMST keeps an MST in a link-cut tree: inserting an edge (or making
+// one lighter) swaps out the heaviest edge on the cycle in O(log V)
 
 #include <iostream>
 #include <vector>
+#include <climits>
 #include <algorithm>
+#include <random>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <type_traits>
+#include <queue>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <atomic>
+#include <thread>
 using namespace std;
 
 // ============================================================================
@@ -32,28 +64,30 @@ struct Edge {
 // UNION-FIND (DISJOINT SET UNION) DATA STRUCTURE
 // ============================================================================
 
+// One int per element: a non-negative entry is the parent, a negative
+// entry marks a root and stores -(rank + 1). A billion elements fit in
+// 4 GB, and find is a loop, so long chains cannot overflow the stack.
 class UnionFind {
 private:
-    vector<int> parent;  // Parent of each vertex
-    vector<int> rank;    // Rank for union by rank optimization
+    vector<int> parent;  // Parent of each vertex, or -(rank + 1) for a root
 
 public:
-    UnionFind(int n) {
-        parent.resize(n);
-        rank.resize(n, 0);
+    // Initially, each vertex is its own root with rank 0
+    UnionFind(int n) : parent(n, -1) {}
 
-        // Initially, each vertex is its own parent
-        for (int i = 0; i < n; i++)
-            parent[i] = i;
-    }
-
-    // Find the root of the set containing x (with path compression)
+    // Find the root of the set containing x (with path halving: every
+    // other vertex on the path is pointed at its grandparent)
     int find(int x) {
-        // If x is not its own parent, recursively find the root
-        if (parent[x] != x) {
-            parent[x] = find(parent[x]); // Path compression
+        while (parent[x] >= 0) {
+            int p = parent[x];
+            if (parent[p] >= 0) {
+                parent[x] = parent[p];
+                x = parent[p];
+            } else {
+                x = p;
+            }
         }
-        return parent[x];
+        return x;
     }
 
     // Union two sets containing x and y
@@ -66,19 +100,401 @@ public:
             return false;
 
         // Union by rank: attach smaller rank to larger rank
-        if (rank[rootX] < rank[rootY]) {
+        // (a larger rank is a more negative entry)
+        if (parent[rootX] > parent[rootY]) {
             parent[rootX] = rootY;
-        } else if (rank[rootX] > rank[rootY]) {
+        } else if (parent[rootX] < parent[rootY]) {
             parent[rootY] = rootX;
         } else {
             parent[rootY] = rootX;
-            rank[rootX]++;
+            parent[rootX]--;
         }
 
         return true;
     }
 };
 
+// ============================================================================
+// ROLLBACK UNION-FIND (Undo unions in LIFO order)
+// ============================================================================
+
+// Union by size without path compression, so every union changes exactly
+// two entries and can be undone: snapshot() marks a point, rollback()
+// restores it. find is O(log n). Used by offline dynamic connectivity and
+// divide-and-conquer algorithms that try unions and then take them back.
+// Roots store -(size) in the same int as the parent.
+class RollbackUnionFind {
+private:
+    vector<int> parent;                   // Parent, or -(set size) for a root
+    vector<pair<int, int>> history;       // (index, old entry) per change
+    int components;
+
+public:
+    RollbackUnionFind(int n) : parent(n, -1), components(n) {}
+
+    int find(int x) const {
+        while (parent[x] >= 0)
+            x = parent[x];
+        return x;
+    }
+
+    bool same(int x, int y) const {
+        return find(x) == find(y);
+    }
+
+    int setSize(int x) const {
+        return -parent[find(x)];
+    }
+
+    int componentCount() const {
+        return components;
+    }
+
+    // Union by size: the smaller set goes under the larger one
+    bool unite(int x, int y) {
+        x = find(x);
+        y = find(y);
+        if (x == y)
+            return false;
+        if (parent[x] > parent[y])
+            swap(x, y);                   // x is now the larger set
+
+        history.push_back(make_pair(x, parent[x]));
+        history.push_back(make_pair(y, parent[y]));
+        parent[x] += parent[y];
+        parent[y] = x;
+        components--;
+        return true;
+    }
+
+    // Current point in the history, to pass to rollback later
+    size_t snapshot() const {
+        return history.size();
+    }
+
+    // Undo every unite made after the given snapshot
+    void rollback(size_t point) {
+        while (history.size() > point) {
+            parent[history.back().first] = history.back().second;
+            history.pop_back();
+            parent[history.back().first] = history.back().second;
+            history.pop_back();
+            components++;
+        }
+    }
+};
+
+// ============================================================================
+// CONCURRENT UNION-FIND (Lock-free, safe to call from many threads at once)
+// ============================================================================
+
+// Each element has one atomic 64-bit word: parent in the low 32 bits, rank
+// in the high 32 bits. Words only change by compare-and-swap, so find,
+// unite and same can all run at the same time without locks.
+//
+// find uses path splitting: every vertex on the path is pointed at its
+// grandparent with one CAS. A failed CAS is not retried (another thread
+// already changed that link), so find never loops on contention and
+// takes at most one step per vertex on the path.
+//
+// unite links one root under the other with a CAS that only succeeds if
+// the lower root is still a root with the rank that was read. Roots are
+// ordered by one of two policies, both giving O(log n) expected height:
+//   RandomIndex: a hashed, seeded priority per index (no rank writes)
+//   Rank:        (rank, index), rank bumped by CAS after equal-rank links
+// Either order is strict and never decreases for a root, so concurrent
+// links can never form a loop.
+class ConcurrentUnionFind {
+public:
+    enum class LinkPolicy { RandomIndex, Rank };
+
+private:
+    vector<atomic<unsigned long long>> word;
+    LinkPolicy policy;
+    unsigned long long seed;
+
+    static unsigned long long pack(int parent, unsigned rank) {
+        return ((unsigned long long)rank << 32) | (unsigned)parent;
+    }
+
+    static int parentOf(unsigned long long w) {
+        return (int)(w & 0xffffffffULL);
+    }
+
+    static unsigned rankOf(unsigned long long w) {
+        return (unsigned)(w >> 32);
+    }
+
+    // Random-looking but fixed priority of index x (splitmix64 finalizer)
+    unsigned long long priority(int x) const {
+        unsigned long long z = (unsigned long long)x + seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // True if root x should be linked under root y
+    bool linksBelow(int x, unsigned rankX, int y, unsigned rankY) const {
+        if (policy == LinkPolicy::Rank) {
+            if (rankX != rankY)
+                return rankX < rankY;
+        } else {
+            unsigned long long px = priority(x), py = priority(y);
+            if (px != py)
+                return px < py;
+        }
+        return x < y;
+    }
+
+public:
+    ConcurrentUnionFind(int n, LinkPolicy linkPolicy = LinkPolicy::RandomIndex,
+                        unsigned long long prioritySeed = 0x9e3779b97f4a7c15ULL)
+        : word(n), policy(linkPolicy), seed(prioritySeed) {
+        for (int i = 0; i < n; i++)
+            word[i].store(pack(i, 0), memory_order_relaxed);
+    }
+
+    // Root of x's set
+    int find(int x) {
+        while (true) {
+            unsigned long long w = word[x].load();
+            int p = parentOf(w);
+            if (p == x)
+                return x;
+
+            unsigned long long pw = word[p].load();
+            int grandparent = parentOf(pw);
+            if (grandparent != p)
+                word[x].compare_exchange_weak(w, pack(grandparent, rankOf(w)));
+            x = p;
+        }
+    }
+
+    // Merge the sets of x and y; false if they were already one set
+    bool unite(int x, int y) {
+        while (true) {
+            x = find(x);
+            y = find(y);
+            if (x == y)
+                return false;
+
+            unsigned long long wx = word[x].load();
+            unsigned long long wy = word[y].load();
+            if (parentOf(wx) != x || parentOf(wy) != y)
+                continue;                    // One stopped being a root
+
+            // Make x the root that goes below
+            if (!linksBelow(x, rankOf(wx), y, rankOf(wy))) {
+                swap(x, y);
+                swap(wx, wy);
+            }
+
+            if (!word[x].compare_exchange_strong(wx, pack(y, rankOf(wx))))
+                continue;
+
+            // Equal ranks: the new root grows (losing this race is fine)
+            if (policy == LinkPolicy::Rank && rankOf(wx) == rankOf(wy))
+                word[y].compare_exchange_strong(wy, pack(y, rankOf(wy) + 1));
+            return true;
+        }
+    }
+
+    // True if x and y are in the same set. Only answers false when x's
+    // root was still a root after y's root was found, so the answer was
+    // true at some instant during the call.
+    bool same(int x, int y) {
+        while (true) {
+            x = find(x);
+            y = find(y);
+            if (x == y)
+                return true;
+            if (parentOf(word[x].load()) == x)
+                return false;
+        }
+    }
+};
+
+// ============================================================================
+// EDGE FILES (Raw Edge records, for graphs that do not fit in memory)
+// ============================================================================
+
+// A file of consecutive Edge structs in host byte order, read and written
+// a block at a time
+
+// Position of edge index in an edge file; false if the seek failed
+inline bool seekEdge(FILE* file, uint64_t index) {
+#if defined(_WIN32)
+    return _fseeki64(file, (long long)(index * sizeof(Edge)), SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)(index * sizeof(Edge)), SEEK_SET) == 0;
+#endif
+}
+
+// A sorted run stored at edges [first, first + count) of a spill file
+struct EdgeSegment {
+    uint64_t first;
+    uint64_t count;
+};
+
+// Reads a whole file it owns, or one segment of a shared spill file. Each
+// segment reader seeks to its own position before refilling its block, so
+// any number of segments can be merged through a single open file.
+class EdgeRun {
+private:
+    FILE* file;
+    bool ownsFile;
+    uint64_t offset = 0;                 // Next edge to read (segments only)
+    uint64_t remaining = UINT64_MAX;     // Edges left to read
+    bool seekFailed = false;
+    vector<Edge> block;
+    size_t position = 0;
+    size_t count = 0;
+
+public:
+    static const size_t BLOCK_EDGES = 1 << 16;
+
+    explicit EdgeRun(FILE* f, size_t blockEdges = BLOCK_EDGES)
+        : file(f), ownsFile(true), block(blockEdges) {}
+
+    EdgeRun(FILE* f, const EdgeSegment& segment, size_t blockEdges)
+        : file(f), ownsFile(false), offset(segment.first), remaining(segment.count),
+          block(blockEdges) {}
+
+    ~EdgeRun() {
+        if (ownsFile && file != nullptr)
+            fclose(file);
+    }
+
+    EdgeRun(const EdgeRun&) = delete;
+    EdgeRun& operator=(const EdgeRun&) = delete;
+
+    // Next edge, false at the end of the file or segment
+    bool next(Edge& edge) {
+        if (position == count) {
+            size_t want = (size_t)min<uint64_t>(block.size(), remaining);
+            if (want == 0)
+                return false;
+            if (!ownsFile && !seekEdge(file, offset)) {
+                seekFailed = true;
+                return false;
+            }
+            count = fread(block.data(), sizeof(Edge), want, file);
+            offset += count;
+            remaining -= count;
+            position = 0;
+            if (count == 0)
+                return false;
+        }
+        edge = block[position++];
+        return true;
+    }
+
+    // Fill list with up to limit edges; returns how many were read
+    size_t read(vector<Edge>& list, size_t limit) {
+        list.resize(limit);
+        size_t got = 0;
+        while (got < limit && next(list[got]))
+            got++;
+        list.resize(got);
+        return got;
+    }
+
+    // True if a read or seek failed, or a segment ended early
+    bool failed() const {
+        return seekFailed || ferror(file) != 0 || (!ownsFile && remaining != 0 && position == count);
+    }
+};
+
+// ============================================================================
+// INDEXED D-ARY HEAP (Min-heap of vertices keyed by weight)
+// ============================================================================
+
+// Each vertex is in the heap at most once; position[] lets decreaseKey find
+// it in O(1). A wider node (D = 4) makes the tree shallower and keeps the
+// children of a node in one cache line.
+template <int D = 4>
+class IndexedDaryHeap {
+private:
+    vector<int> heap;        // Vertices in heap order
+    vector<int> position;    // Index of each vertex in heap, -1 if absent
+    vector<long long> key;
+
+    void moveUp(int i) {
+        int v = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (key[heap[parent]] <= key[v])
+                break;
+            heap[i] = heap[parent];
+            position[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = v;
+        position[v] = i;
+    }
+
+    void moveDown(int i) {
+        int v = heap[i];
+        int count = (int)heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= count)
+                break;
+
+            int smallest = first;
+            int last = min(first + D, count);
+            for (int c = first + 1; c < last; c++) {
+                if (key[heap[c]] < key[heap[smallest]])
+                    smallest = c;
+            }
+            if (key[heap[smallest]] >= key[v])
+                break;
+
+            heap[i] = heap[smallest];
+            position[heap[i]] = i;
+            i = smallest;
+        }
+        heap[i] = v;
+        position[v] = i;
+    }
+
+public:
+    IndexedDaryHeap(int n) : position(n, -1), key(n, 0) {}
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    bool contains(int v) const {
+        return position[v] != -1;
+    }
+
+    // Insert v, or lower its key if it is already in the heap
+    void pushOrDecrease(int v, long long k) {
+        if (position[v] == -1) {
+            key[v] = k;
+            heap.push_back(v);
+            moveUp((int)heap.size() - 1);
+        } else if (k < key[v]) {
+            key[v] = k;
+            moveUp(position[v]);
+        }
+    }
+
+    // Remove and return the vertex with the smallest key
+    int pop() {
+        int top = heap[0];
+        position[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            moveDown(0);
+        }
+        return top;
+    }
+};
+
 // ============================================================================
 // KRUSKAL'S ALGORITHM
 // ============================================================================
@@ -88,6 +504,187 @@ private:
     int vertices;           // Number of vertices
     vector<Edge> edges;     // List of all edges
 
+    // Below this many edges a range is simply sorted
+    static const size_t FILTER_CUTOFF = 64;
+
+    // Plain Kruskal over edges[begin, end), which must be sorted
+    void kruskalRange(const vector<Edge>& work, size_t begin, size_t end,
+                      UnionFind& uf, vector<Edge>& mst) {
+        for (size_t i = begin; i < end && (int)mst.size() < vertices - 1; i++) {
+            if (uf.unite(work[i].source, work[i].destination))
+                mst.push_back(work[i]);
+        }
+    }
+
+    // Filter-Kruskal over work[begin, end), reordering it in place
+    // 1. Split around a random pivot weight: lighter | equal | heavier
+    // 2. Recurse on the lighter part, then take the equal edges
+    // 3. Drop heavier edges that now join one component, loop on the rest
+    void filterKruskal(vector<Edge>& work, size_t begin, size_t end,
+                       UnionFind& uf, vector<Edge>& mst, mt19937& random) {
+        while (end - begin > FILTER_CUTOFF && (int)mst.size() < vertices - 1) {
+            int pivot = work[begin + random() % (end - begin)].weight;
+
+            auto lightEnd = partition(work.begin() + begin, work.begin() + end,
+                                      [pivot](const Edge& e) { return e.weight < pivot; });
+            auto equalEnd = partition(lightEnd, work.begin() + end,
+                                      [pivot](const Edge& e) { return e.weight == pivot; });
+            size_t light = lightEnd - work.begin();
+            size_t equal = equalEnd - work.begin();
+
+            filterKruskal(work, begin, light, uf, mst, random);
+            kruskalRange(work, light, equal, uf, mst);
+
+            // Heavy edges inside one component can never join the MST
+            auto kept = partition(work.begin() + equal, work.begin() + end,
+                                  [&uf](const Edge& e) { return uf.find(e.source) != uf.find(e.destination); });
+            begin = equal;
+            end = kept - work.begin();
+        }
+
+        if ((int)mst.size() < vertices - 1) {
+            sort(work.begin() + begin, work.begin() + end);
+            kruskalRange(work, begin, end, uf, mst);
+        }
+    }
+
+    // Append a sorted run to the spill file and record where it lives
+    static bool appendRun(FILE* spill, const vector<Edge>& run, uint64_t& spilled,
+                          vector<EdgeSegment>& segments) {
+        if (fwrite(run.data(), sizeof(Edge), run.size(), spill) != run.size())
+            return false;
+        segments.push_back({spilled, run.size()});
+        spilled += run.size();
+        return true;
+    }
+
+    // Merge segments [first, last) of file in weight order, passing each edge
+    // to emit until it returns false; ties go to the earlier segment, so the
+    // merge is stable. Returns false on an I/O error.
+    static bool mergeSegments(FILE* file, const vector<EdgeSegment>& segments,
+                              size_t first, size_t last, size_t blockEdges,
+                              const function<bool(const Edge&)>& emit) {
+        vector<unique_ptr<EdgeRun>> runs;
+        for (size_t r = first; r < last; r++)
+            runs.push_back(unique_ptr<EdgeRun>(new EdgeRun(file, segments[r], blockEdges)));
+
+        typedef pair<int, size_t> HeapItem;       // (weight, run)
+        priority_queue<HeapItem, vector<HeapItem>, greater<HeapItem>> heap;
+        vector<Edge> head(runs.size());
+        for (size_t r = 0; r < runs.size(); r++) {
+            if (runs[r]->next(head[r]))
+                heap.push(HeapItem(head[r].weight, r));
+        }
+
+        while (!heap.empty()) {
+            size_t r = heap.top().second;
+            heap.pop();
+            if (!emit(head[r]))
+                return true;
+            if (runs[r]->next(head[r]))
+                heap.push(HeapItem(head[r].weight, r));
+        }
+
+        for (const unique_ptr<EdgeRun>& run : runs) {
+            if (run->failed())
+                return false;
+        }
+        return true;
+    }
+
+    // Strict order on edge indices: weight, then position in edges. With
+    // no ties every cut has one lightest edge, so the MST is unique
+    bool lighter(long long a, long long b) const {
+        if (edges[a].weight != edges[b].weight)
+            return edges[a].weight < edges[b].weight;
+        return a < b;
+    }
+
+    // Run f(thread, begin, end) on threadCount threads over [0, count)
+    template <typename F>
+    static void parallelFor(size_t count, int threadCount, F f) {
+        vector<thread> pool;
+        for (int t = 1; t < threadCount; t++)
+            pool.emplace_back(f, t, count * t / threadCount, count * (t + 1) / threadCount);
+        f(0, (size_t)0, count / threadCount);
+        for (thread& th : pool)
+            th.join();
+    }
+
+    // Stable sort by weight (ties keep insertion order). Integer weights
+    // use an LSD radix sort, 8 bits per pass, with signed weights mapped
+    // to unsigned keys; a pass in which every edge has the same digit is
+    // skipped, so small weight ranges cost one or two passes. Each pass
+    // is split across threads: per-thread histograms, then every thread
+    // scatters its own slice to offsets computed in thread order.
+    static void sortByWeight(vector<Edge>& list, int threadCount) {
+        typedef decltype(Edge::weight) Weight;
+        if constexpr (!is_integral<Weight>::value || sizeof(Weight) != 4) {
+            stable_sort(list.begin(), list.end());
+            return;
+        } else {
+            size_t n = list.size();
+            if (n < 2)
+                return;
+            threadCount = (int)max<size_t>(1, min<size_t>(threadCount, n / 4096 + 1));
+            vector<Edge> buffer(n);
+            vector<array<size_t, 256>> counts(threadCount);
+
+            auto digit = [](const Edge& e, int shift) {
+                return (((unsigned)e.weight ^ 0x80000000u) >> shift) & 0xff;
+            };
+
+            for (int shift = 0; shift < 32; shift += 8) {
+                parallelFor(n, threadCount, [&](int t, size_t begin, size_t end) {
+                    counts[t].fill(0);
+                    for (size_t i = begin; i < end; i++)
+                        counts[t][digit(list[i], shift)]++;
+                });
+
+                // Skip the pass if one digit value covers every edge
+                size_t first = 0;
+                for (int t = 0; t < threadCount; t++)
+                    first += counts[t][digit(list[0], shift)];
+                if (first == n)
+                    continue;
+
+                // Turn counts into starting offsets (digit-major, then thread)
+                size_t offset = 0;
+                for (int d = 0; d < 256; d++) {
+                    for (int t = 0; t < threadCount; t++) {
+                        size_t count = counts[t][d];
+                        counts[t][d] = offset;
+                        offset += count;
+                    }
+                }
+
+                parallelFor(n, threadCount, [&](int t, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                        buffer[counts[t][digit(list[i], shift)]++] = list[i];
+                });
+                list.swap(buffer);
+            }
+        }
+    }
+
+    static long long weightOf(const vector<Edge>& mst) {
+        long long total = 0;
+        for (const Edge& edge : mst)
+            total += edge.weight;
+        return total;
+    }
+
+    // Print the MST edges and total weight
+    void printMST(const vector<Edge>& mst, long long totalWeight) {
+        cout << "\n=== Minimum Spanning Tree ===\n";
+        cout << "Edges in MST:\n";
+        for (const Edge& edge : mst) {
+            cout << edge.source << " - " << edge.destination
+                 << " : " << edge.weight << "\n";
+        }
+        cout << "\nTotal weight of MST: " << totalWeight << "\n";
+    }
+
 public:
     Graph(int v) : vertices(v) {}
 
@@ -98,16 +695,17 @@ public:
     }
 
     // Main Kruskal's algorithm
-    void kruskalMST() {
+    // threadCount > 1 splits the sort across threads
+    void kruskalMST(int threadCount = 1) {
         // Step 1: Sort all edges by weight (ascending order)
-        sort(edges.begin(), edges.end());
+        sortByWeight(edges, threadCount);
 
         // Step 2: Initialize Union-Find structure
         UnionFind uf(vertices);
 
         // Step 3: Process edges and build MST
         vector<Edge> mst;      // Edges in MST
-        int totalWeight = 0;   // Sum of weights in MST
+        long long totalWeight = 0;   // Sum of weights in MST (64-bit)
 
         cout << "Building Minimum Spanning Tree using Kruskal's Algorithm:\n";
         cout << "Edge (u-v) : Weight | Action\n";
@@ -137,13 +735,757 @@ public:
         }
 
         // Step 4: Print MST
-        cout << "\n=== Minimum Spanning Tree ===\n";
-        cout << "Edges in MST:\n";
-        for (const Edge& edge : mst) {
-            cout << edge.source << " - " << edge.destination 
-                 << " : " << edge.weight << "\n";
+        printMST(mst, totalWeight);
+    }
+
+    // Kruskal without output: the MST (spanning forest if disconnected)
+    // edges, lightest first. Seeds DynamicMST.
+    vector<Edge> minimumSpanningForest(int threadCount = 1) {
+        sortByWeight(edges, threadCount);
+        UnionFind uf(vertices);
+        vector<Edge> mst;
+        kruskalRange(edges, 0, edges.size(), uf, mst);
+        return mst;
+    }
+
+    // Filter-Kruskal: same MST weight as kruskalMST, without sorting the
+    // edges that end up filtered out
+    void filterKruskalMST() {
+        vector<Edge> work(edges);
+        UnionFind uf(vertices);
+        vector<Edge> mst;
+        mt19937 random(12345);
+
+        filterKruskal(work, 0, work.size(), uf, mst, random);
+
+        long long totalWeight = 0;
+        for (const Edge& edge : mst)
+            totalWeight += edge.weight;
+
+        cout << "Building Minimum Spanning Tree using Filter-Kruskal\n";
+        printMST(mst, totalWeight);
+    }
+    // Parallel Boruvka MST
+    // Each round:
+    // 1. Every thread scans its slice of the live edges and lowers, with a
+    //    CAS, the best edge recorded for the components at both ends
+    // 2. Every component's best edge is united in parallel; only the thread
+    //    whose unite succeeds keeps the edge (an edge picked by both its
+    //    components is kept once)
+    // 3. Contraction: edges now inside one component are dropped; each
+    //    thread's survivors are copied back at prefix offsets in parallel
+    // Ties are broken by edge position, so the result is deterministic and
+    // always has kruskalMST's total weight. Disconnected graphs get a
+    // minimum spanning forest.
+    void boruvkaMST(int threadCount = 0) {
+        if (threadCount <= 0)
+            threadCount = (int)max(1u, thread::hardware_concurrency());
+
+        ConcurrentUnionFind uf(vertices);
+        vector<atomic<long long>> best(vertices);    // Best edge per component root, -1 if none
+        vector<vector<long long>> picked(threadCount);
+        vector<vector<long long>> kept(threadCount);
+
+        vector<long long> live(edges.size());
+        for (size_t i = 0; i < edges.size(); i++)
+            live[i] = (long long)i;
+
+        int rounds = 0;
+        while (!live.empty()) {
+            rounds++;
+            parallelFor(vertices, threadCount, [&](int, size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++)
+                    best[v].store(-1, memory_order_relaxed);
+            });
+
+            // Step 1: lightest outgoing edge per component
+            parallelFor(live.size(), threadCount, [&](int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    long long e = live[i];
+                    int ru = uf.find(edges[e].source);
+                    int rv = uf.find(edges[e].destination);
+                    if (ru == rv)
+                        continue;
+
+                    for (int root : {ru, rv}) {
+                        long long current = best[root].load(memory_order_relaxed);
+                        while (current == -1 || lighter(e, current)) {
+                            if (best[root].compare_exchange_weak(current, e, memory_order_relaxed))
+                                break;
+                        }
+                    }
+                }
+            });
+
+            // Step 2: merge along the picked edges
+            parallelFor(vertices, threadCount, [&](int t, size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++) {
+                    long long e = best[v].load(memory_order_relaxed);
+                    if (e != -1 && uf.unite(edges[e].source, edges[e].destination))
+                        picked[t].push_back(e);
+                }
+            });
+
+            // Step 3: contract, keeping only edges between components
+            parallelFor(live.size(), threadCount, [&](int t, size_t begin, size_t end) {
+                kept[t].clear();
+                for (size_t i = begin; i < end; i++) {
+                    long long e = live[i];
+                    if (uf.find(edges[e].source) != uf.find(edges[e].destination))
+                        kept[t].push_back(e);
+                }
+            });
+
+            // Gather the kept parts at prefix offsets, one thread per part
+            vector<size_t> offset(threadCount + 1, 0);
+            for (int t = 0; t < threadCount; t++)
+                offset[t + 1] = offset[t] + kept[t].size();
+            live.resize(offset[threadCount]);             // Never grows
+            parallelFor(threadCount, threadCount, [&](int, size_t begin, size_t end) {
+                for (size_t t = begin; t < end; t++)
+                    copy(kept[t].begin(), kept[t].end(), live.begin() + offset[t]);
+            });
         }
-        cout << "\nTotal weight of MST: " << totalWeight << "\n";
+
+        // Collect the MST, lightest edge first
+        vector<long long> chosen;
+        for (const vector<long long>& part : picked)
+            chosen.insert(chosen.end(), part.begin(), part.end());
+        sort(chosen.begin(), chosen.end(), [this](long long a, long long b) { return lighter(a, b); });
+
+        vector<Edge> mst;
+        long long totalWeight = 0;
+        for (long long e : chosen) {
+            mst.push_back(edges[e]);
+            totalWeight += edges[e].weight;
+        }
+
+        cout << "Building Minimum Spanning Tree using parallel Boruvka ("
+             << threadCount << " threads, " << rounds << " rounds)\n";
+        printMST(mst, totalWeight);
+    }
+    // Write every edge to path in the format externalKruskalMST reads
+    bool saveEdges(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        bool ok = edges.empty() || fwrite(edges.data(), sizeof(Edge), edges.size(), file) == edges.size();
+        return fclose(file) == 0 && ok;
+    }
+
+    // Out-of-core Kruskal over an edge file (see saveEdges)
+    // 1. Read runEdges edges at a time, radix-sort them and append each run
+    //    to one temporary spill file (a single run is never written out)
+    // 2. While there are more than fanIn runs, merge consecutive groups of
+    //    fanIn runs into a new spill file
+    // 3. Merge the last (at most fanIn) runs with a min-heap holding one edge
+    //    per run, feeding edges to Kruskal in weight order; ties go to the
+    //    earlier run, so ties resolve in file order as in kruskalMST
+    // fanIn = 0 merges every run at once as long as each merge block keeps
+    // MIN_MERGE_BLOCK_EDGES edges (2047 runs with the default runEdges, about
+    // 400 GB of input), so the input is read once and the runs are written
+    // and read once; only bigger inputs take an extra pass.
+    // Each MST edge is passed to onEdge as soon as it is found, and the
+    // merge stops after vertices - 1 of them. At most two files are open at
+    // once. Peak memory is the union-find plus two run buffers (the radix
+    // sort needs a scratch copy); both are freed before merging, and the
+    // merge blocks (fanIn + 1 of them) share a budget of runEdges edges.
+    // Returns false on an I/O error.
+    static const size_t MIN_MERGE_BLOCK_EDGES = 1 << 13;      // 96 KB
+
+    static bool externalKruskalMST(const string& path, int vertices,
+                                   const function<void(const Edge&)>& onEdge,
+                                   long long& totalWeight,
+                                   size_t runEdges = (size_t)1 << 24,
+                                   size_t fanIn = 0) {
+        FILE* input = fopen(path.c_str(), "rb");
+        if (input == nullptr)
+            return false;
+
+        // Step 1: sorted runs
+        unique_ptr<FILE, int (*)(FILE*)> spill(nullptr, &fclose);
+        vector<EdgeSegment> segments;
+        uint64_t spilled = 0;
+        vector<Edge> buffer;
+        bool ok = true;
+        {
+            EdgeRun reader(input);
+            while (reader.read(buffer, runEdges) > 0) {
+                sortByWeight(buffer, 1);
+                if (segments.empty() && buffer.size() < runEdges)
+                    break;                        // Everything fit in memory
+
+                if (spill == nullptr)
+                    spill.reset(tmpfile());
+                if (spill == nullptr || !appendRun(spill.get(), buffer, spilled, segments)) {
+                    ok = false;
+                    break;
+                }
+            }
+            ok = ok && !reader.failed();
+        }
+        if (!ok)
+            return false;
+
+        UnionFind uf(vertices);
+        int treeEdges = 0;
+        totalWeight = 0;
+
+        auto take = [&](const Edge& edge) {
+            if (uf.unite(edge.source, edge.destination)) {
+                totalWeight += edge.weight;
+                treeEdges++;
+                onEdge(edge);
+            }
+            return treeEdges < vertices - 1;
+        };
+
+        if (segments.empty()) {
+            for (const Edge& edge : buffer) {
+                if (!take(edge))
+                    break;
+            }
+            return true;
+        }
+        vector<Edge>().swap(buffer);              // clear() would keep the capacity
+
+        // Widest merge whose blocks stay at least MIN_MERGE_BLOCK_EDGES long
+        if (fanIn == 0)
+            fanIn = min(segments.size(), max<size_t>(runEdges / MIN_MERGE_BLOCK_EDGES, 2) - 1);
+        fanIn = max<size_t>(min(fanIn, segments.size()), 2);
+        size_t blockEdges = max<size_t>(runEdges / (fanIn + 1), 1);
+
+        // Step 2: multi-pass merge down to fanIn runs
+        while (segments.size() > fanIn) {
+            unique_ptr<FILE, int (*)(FILE*)> next(tmpfile(), &fclose);
+            if (next == nullptr)
+                return false;
+
+            vector<EdgeSegment> merged;
+            uint64_t written = 0;
+            vector<Edge> out;
+            out.reserve(blockEdges);
+            auto flush = [&]() {
+                bool flushed = fwrite(out.data(), sizeof(Edge), out.size(), next.get()) == out.size();
+                written += out.size();
+                out.clear();
+                return flushed;
+            };
+
+            for (size_t first = 0; first < segments.size(); first += fanIn) {
+                size_t last = min(first + fanIn, segments.size());
+                uint64_t start = written;
+                bool writeOk = true;
+                ok = mergeSegments(spill.get(), segments, first, last, blockEdges,
+                                   [&](const Edge& edge) {
+                                       out.push_back(edge);
+                                       if (out.size() == blockEdges)
+                                           writeOk = flush();
+                                       return writeOk;
+                                   });
+                if (!ok || !writeOk || !flush())
+                    return false;
+                merged.push_back({start, written - start});
+            }
+
+            spill = move(next);
+            segments.swap(merged);
+        }
+
+        // Step 3: final merge into Kruskal
+        return mergeSegments(spill.get(), segments, 0, segments.size(), blockEdges, take);
+    }
+    // Which MST engine adaptiveMST uses
+    enum class MSTEngine { Kruskal, PrimHeap, PrimDense };
+
+    // Dense Prim is only used while its V x V matrix stays within 512 MB
+    static const int DENSE_PRIM_MAX_VERTICES = 8192;
+
+    // Heap Prim needs at least this average degree (2E / V)
+    static const int HEAP_PRIM_MIN_DEGREE = 128;
+
+    // Engine choice from the edge density E / (V(V-1)/2), measured on one
+    // core with uniformly random weights for V = 2000 to 200000:
+    // - at least half of all pairs: dense Prim (the V^2 scan is then
+    //   linear in E and needs no sort or heap)
+    // - heap Prim when the average degree is at least 128, the weights
+    //   differ in 3 or 4 bytes (so the radix sort makes 3-4 passes) and the
+    //   edges are listed grouped by source (adjacency order, so the CSR
+    //   build streams): it took 0.70-0.90x Kruskal's time there
+    // - otherwise Kruskal: with shuffled edges, narrower weights or a lower
+    //   degree heap Prim took 1.0-2.4x as long, its CSR build and heap
+    //   traffic being random access
+    MSTEngine chooseMSTEngine() const {
+        double pairs = (double)vertices * (vertices - 1) / 2;
+        double e = (double)edges.size();
+        if (vertices > 1 && e >= pairs / 2 && vertices <= DENSE_PRIM_MAX_VERTICES)
+            return MSTEngine::PrimDense;
+        if (vertices == 0 || 2 * e < (double)HEAP_PRIM_MIN_DEGREE * vertices)
+            return MSTEngine::Kruskal;
+
+        // One scan: which weight bytes vary, and are sources non-decreasing
+        unsigned varying = 0;
+        bool grouped = true;
+        for (size_t i = 1; i < edges.size(); i++) {
+            varying |= (unsigned)edges[i].weight ^ (unsigned)edges[0].weight;
+            grouped = grouped && edges[i - 1].source <= edges[i].source;
+        }
+        int radixPasses = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+            radixPasses += ((varying >> shift) & 0xff) != 0;
+
+        return grouped && radixPasses >= 3 ? MSTEngine::PrimHeap : MSTEngine::Kruskal;
+    }
+
+    // Prim with an indexed 4-ary heap over a CSR adjacency, O(E log V).
+    // Grows one tree per connected component (spanning forest).
+    vector<Edge> primHeapForest() const {
+        // CSR adjacency: both directions of every edge
+        vector<int> offset(vertices + 1, 0);
+        for (const Edge& edge : edges) {
+            offset[edge.source + 1]++;
+            offset[edge.destination + 1]++;
+        }
+        for (int v = 0; v < vertices; v++)
+            offset[v + 1] += offset[v];
+
+        vector<int> fill(offset.begin(), offset.end() - 1);
+        vector<int> target(offset[vertices]);
+        vector<int> weight(offset[vertices]);
+        for (const Edge& edge : edges) {
+            target[fill[edge.source]] = edge.destination;
+            weight[fill[edge.source]++] = edge.weight;
+            target[fill[edge.destination]] = edge.source;
+            weight[fill[edge.destination]++] = edge.weight;
+        }
+
+        vector<Edge> mst;
+        vector<bool> inTree(vertices, false);
+        vector<int> bestWeight(vertices, INT_MAX);
+        vector<int> bestFrom(vertices, -1);
+        IndexedDaryHeap<4> heap(vertices);
+
+        for (int start = 0; start < vertices; start++) {
+            if (inTree[start])
+                continue;
+            heap.pushOrDecrease(start, LLONG_MIN);
+
+            while (!heap.empty()) {
+                int u = heap.pop();
+                inTree[u] = true;
+                if (bestFrom[u] != -1)
+                    mst.push_back({bestFrom[u], u, bestWeight[u]});
+
+                for (int i = offset[u]; i < offset[u + 1]; i++) {
+                    int v = target[i];
+                    if (!inTree[v] && (bestFrom[v] == -1 || weight[i] < bestWeight[v])) {
+                        bestWeight[v] = weight[i];
+                        bestFrom[v] = u;
+                        heap.pushOrDecrease(v, weight[i]);
+                    }
+                }
+            }
+        }
+        return mst;
+    }
+
+    // Prim on a V x V matrix of the lightest edge per pair: every step scans
+    // the vertices still outside the tree for the cheapest one, O(V^2) time
+    // and memory, no heap. The matrix holds 64-bit weights so LLONG_MAX can
+    // mean "no edge" even when INT_MAX is a real weight.
+    vector<Edge> primDenseForest() const {
+        const long long NONE = LLONG_MAX;
+        vector<long long> matrix((size_t)vertices * vertices, NONE);
+        for (const Edge& edge : edges) {
+            if (edge.source == edge.destination)
+                continue;
+            long long& ab = matrix[(size_t)edge.source * vertices + edge.destination];
+            if (edge.weight < ab)
+                ab = matrix[(size_t)edge.destination * vertices + edge.source] = edge.weight;
+        }
+
+        vector<Edge> mst;
+        vector<long long> bestWeight(vertices, NONE);
+        vector<int> bestFrom(vertices, -1);
+        vector<int> outside(vertices);            // Vertices not yet in a tree
+        for (int v = 0; v < vertices; v++)
+            outside[v] = v;
+
+        while (!outside.empty()) {
+            // Cheapest vertex next to the tree; if none is linked to it,
+            // the first remaining vertex starts a new tree (next component)
+            size_t pick = 0;
+            for (size_t i = 1; i < outside.size(); i++) {
+                if (bestWeight[outside[i]] < bestWeight[outside[pick]])
+                    pick = i;
+            }
+            int u = outside[pick];
+            outside[pick] = outside.back();
+            outside.pop_back();
+
+            if (bestFrom[u] != -1)
+                mst.push_back({bestFrom[u], u, (int)bestWeight[u]});
+
+            const long long* row = &matrix[(size_t)u * vertices];
+            for (int v : outside) {
+                if (row[v] < bestWeight[v]) {
+                    bestWeight[v] = row[v];
+                    bestFrom[v] = u;
+                }
+            }
+        }
+        return mst;
+    }
+
+    // MST (spanning forest) edges from the given engine
+    vector<Edge> computeMST(MSTEngine engine) {
+        switch (engine) {
+        case MSTEngine::PrimHeap:
+            return primHeapForest();
+        case MSTEngine::PrimDense:
+            return primDenseForest();
+        default:
+            return minimumSpanningForest();
+        }
+    }
+
+    // Prim's algorithm with the indexed heap
+    void primMST() {
+        vector<Edge> mst = primHeapForest();
+        cout << "Building Minimum Spanning Tree using Prim's Algorithm (4-ary heap)\n";
+        printMST(mst, weightOf(mst));
+    }
+
+    // Prim's algorithm with the O(V^2) array scan
+    void densePrimMST() {
+        vector<Edge> mst = primDenseForest();
+        cout << "Building Minimum Spanning Tree using Prim's Algorithm (dense)\n";
+        printMST(mst, weightOf(mst));
+    }
+
+    // Pick the engine from the graph's density, then build the MST
+    void adaptiveMST() {
+        static const char* names[] = {"Kruskal", "Prim (4-ary heap)", "Prim (dense)"};
+        MSTEngine engine = chooseMSTEngine();
+        vector<Edge> mst = computeMST(engine);
+        cout << "Building Minimum Spanning Tree using " << names[(int)engine]
+             << " (chosen for " << edges.size() << " edges on " << vertices << " vertices)\n";
+        printMST(mst, weightOf(mst));
+    }
+};
+
+// ============================================================================
+// LINK-CUT TREE (Dynamic forest with path-maximum queries)
+// ============================================================================
+
+// Sleator-Tarjan link-cut tree over nodes 0..n-1, each with a value. Every
+// preferred path is a splay tree ordered by depth; each splay node knows
+// the node with the largest value in its splay subtree. All operations
+// are O(log n) amortized.
+class LinkCutTree {
+private:
+    vector<int> left, right, up;     // Splay children; up = splay parent or path parent
+    vector<bool> flipped;            // Pending reversal of the splay subtree
+    vector<long long> value;
+    vector<int> best;                // Node with the largest value below (splay)
+    vector<int> scratch;             // Path buffer for splay
+
+    bool isSplayRoot(int x) const {
+        return up[x] == -1 || (left[up[x]] != x && right[up[x]] != x);
+    }
+
+    void pull(int x) {
+        best[x] = x;
+        if (left[x] != -1 && value[best[left[x]]] > value[best[x]])
+            best[x] = best[left[x]];
+        if (right[x] != -1 && value[best[right[x]]] > value[best[x]])
+            best[x] = best[right[x]];
+    }
+
+    void push(int x) {
+        if (flipped[x]) {
+            swap(left[x], right[x]);
+            if (left[x] != -1)
+                flipped[left[x]] = !flipped[left[x]];
+            if (right[x] != -1)
+                flipped[right[x]] = !flipped[right[x]];
+            flipped[x] = false;
+        }
+    }
+
+    void rotate(int x) {
+        int p = up[x];
+        int g = up[p];
+        if (!isSplayRoot(p)) {
+            if (left[g] == p)
+                left[g] = x;
+            else
+                right[g] = x;
+        }
+        up[x] = g;
+
+        if (left[p] == x) {
+            left[p] = right[x];
+            if (right[x] != -1)
+                up[right[x]] = p;
+            right[x] = p;
+        } else {
+            right[p] = left[x];
+            if (left[x] != -1)
+                up[left[x]] = p;
+            left[x] = p;
+        }
+        up[p] = x;
+        pull(p);
+        pull(x);
+    }
+
+    void splay(int x) {
+        // Apply pending flips from the splay root down to x
+        scratch.clear();
+        for (int y = x;; y = up[y]) {
+            scratch.push_back(y);
+            if (isSplayRoot(y))
+                break;
+        }
+        for (int i = (int)scratch.size() - 1; i >= 0; i--)
+            push(scratch[i]);
+
+        while (!isSplayRoot(x)) {
+            int p = up[x];
+            if (!isSplayRoot(p))
+                rotate((left[p] == x) == (left[up[p]] == p) ? p : x);
+            rotate(x);
+        }
+    }
+
+    // Make the root-to-x path preferred; x ends up as its splay root
+    void access(int x) {
+        int last = -1;
+        for (int y = x; y != -1; y = up[y]) {
+            splay(y);
+            right[y] = last;
+            pull(y);
+            last = y;
+        }
+        splay(x);
+    }
+
+    void makeRoot(int x) {
+        access(x);
+        flipped[x] = !flipped[x];
+    }
+
+public:
+    LinkCutTree(int n)
+        : left(n, -1), right(n, -1), up(n, -1), flipped(n, false), value(n, 0), best(n) {
+        for (int i = 0; i < n; i++)
+            best[i] = i;
+    }
+
+    // Change x's value (x may be anywhere in the forest)
+    void setValue(int x, long long v) {
+        access(x);
+        value[x] = v;
+        pull(x);
+    }
+
+    long long getValue(int x) const {
+        return value[x];
+    }
+
+    int findRoot(int x) {
+        access(x);
+        push(x);
+        while (left[x] != -1) {
+            x = left[x];
+            push(x);
+        }
+        splay(x);
+        return x;
+    }
+
+    bool connected(int x, int y) {
+        return x == y || findRoot(x) == findRoot(y);
+    }
+
+    // Add edge x - y; x and y must be in different trees
+    void link(int x, int y) {
+        makeRoot(x);
+        up[x] = y;
+    }
+
+    // Remove edge x - y; it must exist
+    void cut(int x, int y) {
+        makeRoot(x);
+        access(y);
+        // x is now y's left child, with nothing else on the path
+        left[y] = -1;
+        up[x] = -1;
+        pull(y);
+    }
+
+    // Node with the largest value on the path x ... y (same tree)
+    int pathMax(int x, int y) {
+        makeRoot(x);
+        access(y);
+        return best[y];
+    }
+};
+
+// ============================================================================
+// DYNAMIC MST (Edge insertions and weight decreases)
+// ============================================================================
+
+// Keeps a minimum spanning forest as a link-cut tree. Vertex v is node v;
+// each tree edge is its own node (V + slot) joined to both endpoints, so
+// path maxima give the heaviest tree edge between two vertices.
+// A new edge u - v of weight w either joins two trees, or closes a cycle:
+// if the heaviest edge on the tree path u ... v is heavier than w, it is
+// swapped out, otherwise the new edge is dropped. Dropped edges are never
+// needed again: under insertions and decreases an edge that is heaviest on
+// some cycle stays out of the MST. Weight increases are not supported.
+class DynamicMST {
+private:
+    int vertices;
+    LinkCutTree forest;
+    vector<Edge> slotEdge;                   // Tree edge held by each edge node
+    vector<int> freeSlots;
+    unordered_map<long long, int> slotOf;    // Vertex pair -> edge slot
+    long long totalWeight = 0;
+    int treeEdgeCount = 0;
+
+    long long pairKey(int u, int v) const {
+        if (u > v)
+            swap(u, v);
+        return (long long)u * vertices + v;
+    }
+
+    void addTreeEdge(const Edge& edge) {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        slotEdge[slot] = edge;
+        slotOf[pairKey(edge.source, edge.destination)] = slot;
+
+        int node = vertices + slot;
+        forest.setValue(node, edge.weight);
+        forest.link(edge.source, node);
+        forest.link(node, edge.destination);
+        totalWeight += edge.weight;
+        treeEdgeCount++;
+    }
+
+    void removeTreeEdge(int slot) {
+        const Edge& edge = slotEdge[slot];
+        int node = vertices + slot;
+        forest.cut(edge.source, node);
+        forest.cut(node, edge.destination);
+        slotOf.erase(pairKey(edge.source, edge.destination));
+        totalWeight -= edge.weight;
+        treeEdgeCount--;
+        freeSlots.push_back(slot);
+    }
+
+public:
+    // Start from a minimum spanning forest (e.g. Graph::minimumSpanningForest)
+    DynamicMST(int v, const vector<Edge>& mst)
+        : vertices(v), forest(2 * v), slotEdge(v) {
+        for (int i = 0; i < v; i++)
+            forest.setValue(i, LLONG_MIN);   // Vertices never win a path max
+        for (int slot = v - 1; slot >= 0; slot--)
+            freeSlots.push_back(slot);
+        for (const Edge& edge : mst)
+            addTreeEdge(edge);
+    }
+
+    // Insert edge u - v of weight w; true if it entered the MST
+    bool insertEdge(int u, int v, int w) {
+        if (u == v)
+            return false;
+
+        Edge edge = {u, v, w};
+        if (!forest.connected(u, v)) {
+            addTreeEdge(edge);
+            return true;
+        }
+
+        int heaviest = forest.pathMax(u, v);
+        if (forest.getValue(heaviest) <= w)
+            return false;
+
+        removeTreeEdge(heaviest - vertices);
+        addTreeEdge(edge);
+        return true;
+    }
+
+    // Lower the weight of an edge u - v to w. Edges are known by vertex
+    // pair, and only the lightest u - v edge can be in the MST: if the tree
+    // already holds a u - v edge of weight at most w, the update is for a
+    // parallel non-tree edge and changes nothing. A heavier tree edge just
+    // gets lighter; any other edge is treated as a new insertion.
+    // Returns true if the MST changed.
+    bool decreaseWeight(int u, int v, int w) {
+        auto found = slotOf.find(pairKey(u, v));
+        if (found == slotOf.end())
+            return insertEdge(u, v, w);
+
+        int slot = found->second;
+        if (w >= slotEdge[slot].weight)
+            return false;
+
+        totalWeight += (long long)w - slotEdge[slot].weight;
+        slotEdge[slot].weight = w;
+        forest.setValue(vertices + slot, w);
+        return true;
+    }
+
+    // Apply many insertions / decreases; only the lightest update per
+    // vertex pair matters, so duplicates are dropped first.
+    // Returns how many of the remaining updates changed the MST.
+    int applyBatch(const vector<Edge>& updates) {
+        unordered_map<long long, size_t> lightest;
+        for (size_t i = 0; i < updates.size(); i++) {
+            long long key = pairKey(updates[i].source, updates[i].destination);
+            auto found = lightest.find(key);
+            if (found == lightest.end())
+                lightest[key] = i;
+            else if (updates[i].weight < updates[found->second].weight)
+                found->second = i;
+        }
+
+        int changed = 0;
+        for (size_t i = 0; i < updates.size(); i++) {
+            if (lightest[pairKey(updates[i].source, updates[i].destination)] != i)
+                continue;
+            if (decreaseWeight(updates[i].source, updates[i].destination, updates[i].weight))
+                changed++;
+        }
+        return changed;
+    }
+
+    long long getTotalWeight() const {
+        return totalWeight;
+    }
+
+    int getTreeEdgeCount() const {
+        return treeEdgeCount;
+    }
+
+    bool connected(int u, int v) {
+        return forest.connected(u, v);
+    }
+
+    // Current tree edges, lightest first
+    vector<Edge> treeEdges() const {
+        vector<Edge> result;
+        for (const auto& entry : slotOf)
+            result.push_back(slotEdge[entry.second]);
+        stable_sort(result.begin(), result.end(), [](const Edge& a, const Edge& b) {
+            if (a.weight != b.weight)
+                return a.weight < b.weight;
+            return make_pair(a.source, a.destination) < make_pair(b.source, b.destination);
+        });
+        return result;
     }
 };
 
@@ -197,6 +1539,130 @@ int main() {
     g3.addEdge(0, 3, 5);
 
     g3.kruskalMST();
+    cout << "\n";
+
+    // Test case 4: Filter-Kruskal on the same graphs
+    cout << "Test 4: Filter-Kruskal mode\n";
+    cout << "Graph from Test 1:\n";
+    g1.filterKruskalMST();
+    cout << "Graph from Test 2:\n";
+    g2.filterKruskalMST();
+    cout << "\n";
+
+    // Test case 5: Parallel Boruvka on the same graphs
+    cout << "Test 5: Parallel Boruvka mode (4 threads)\n";
+    cout << "Graph from Test 1:\n";
+    g1.boruvkaMST(4);
+    cout << "Graph from Test 3:\n";
+    g3.boruvkaMST(4);
+    cout << "\n";
+
+    // Test case 6: Connected components with threads sharing one
+    // lock-free union-find
+    cout << "Test 6: Concurrent UnionFind (4 threads)\n";
+    cout << "Pairs: 0-1, 2-3, 1-2, 5-6, 6-7, 7-5 (vertices 0..7)\n";
+    int pairs[6][2] = {{0, 1}, {2, 3}, {1, 2}, {5, 6}, {6, 7}, {7, 5}};
+
+    for (ConcurrentUnionFind::LinkPolicy policy : {ConcurrentUnionFind::LinkPolicy::RandomIndex,
+                                                   ConcurrentUnionFind::LinkPolicy::Rank}) {
+        ConcurrentUnionFind cuf(8, policy);
+        atomic<int> merges(0);
+        vector<thread> pool;
+        for (int t = 0; t < 4; t++) {
+            pool.emplace_back([&, t]() {
+                for (int i = t; i < 6; i += 4) {
+                    if (cuf.unite(pairs[i][0], pairs[i][1]))
+                        merges++;
+                }
+            });
+        }
+        for (thread& th : pool)
+            th.join();
+
+        cout << (policy == ConcurrentUnionFind::LinkPolicy::Rank ? "Rank" : "Random index")
+             << " linking: " << 8 - merges.load() << " components, "
+             << "same(0, 3) = " << cuf.same(0, 3) << ", same(3, 5) = " << cuf.same(3, 5) << "\n";
+    }
+    cout << "\n";
+
+    // Test case 7: Try unions and take them back
+    cout << "Test 7: Rollback UnionFind\n";
+    RollbackUnionFind ruf(5);
+    ruf.unite(0, 1);
+    size_t point = ruf.snapshot();
+    ruf.unite(1, 2);
+    ruf.unite(3, 4);
+    cout << "After 0-1, snapshot, 1-2, 3-4: " << ruf.componentCount()
+         << " components, size of 0's set = " << ruf.setSize(0) << "\n";
+    ruf.rollback(point);
+    cout << "After rollback: " << ruf.componentCount()
+         << " components, same(1, 2) = " << ruf.same(1, 2)
+         << ", same(0, 1) = " << ruf.same(0, 1) << "\n\n";
+
+    // Test case 8: MST streamed from an edge file, 2 edges per run, runs
+    // merged 2 at a time (so the merge takes more than one pass)
+    cout << "Test 8: External-memory Kruskal (graph from Test 2)\n";
+    string edgePath = "krush_edges.bin";
+    long long streamedWeight = 0;
+    if (g2.saveEdges(edgePath) &&
+        Graph::externalKruskalMST(edgePath, 4, [](const Edge& edge) {
+            cout << edge.source << " - " << edge.destination << " : " << edge.weight << "\n";
+        }, streamedWeight, 2, 2)) {
+        cout << "Total weight of MST: " << streamedWeight << "\n";
+    } else {
+        cout << "Edge file I/O failed\n";
+    }
+    remove(edgePath.c_str());
+    cout << "\n";
+
+    // Test case 9: Keep the MST of Test 1 up to date
+    cout << "Test 9: Dynamic MST (graph from Test 1)\n";
+    DynamicMST dynamic(5, g1.minimumSpanningForest());
+    cout << "Seeded from Kruskal, total weight: " << dynamic.getTotalWeight() << "\n";
+
+    dynamic.insertEdge(0, 4, 3);
+    cout << "insertEdge 0-4(3) (replaces 1-3(5)): " << dynamic.getTotalWeight() << "\n";
+
+    dynamic.decreaseWeight(0, 2, 1);
+    cout << "decreaseWeight 0-2 to 1 (tree edge): " << dynamic.getTotalWeight() << "\n";
+
+    Edge batch[] = {{2, 4, 9}, {1, 4, 2}, {1, 4, 0}, {3, 2, 6}};
+    dynamic.applyBatch(vector<Edge>(batch, batch + 4));
+    cout << "Batch 2-4(9), 1-4(2), 1-4(0), 3-2(6): " << dynamic.getTotalWeight() << "\n";
+
+    // A parallel 3-4 edge getting lighter, but still heavier than the
+    // 3-4(2) tree edge, is accepted and leaves the MST alone
+    bool changed = dynamic.decreaseWeight(3, 4, 5);
+    cout << "decreaseWeight 3-4 to 5 (parallel to tree edge 3-4(2)), MST changed? "
+         << (changed ? "Yes" : "No") << ": " << dynamic.getTotalWeight() << "\n";
+    for (const Edge& edge : dynamic.treeEdges())
+        cout << edge.source << " - " << edge.destination << " : " << edge.weight << "\n";
+    cout << "\n";
+
+    // Test case 10: Prim engines and the density-based dispatcher
+    cout << "Test 10: Prim's algorithm and adaptive engine choice\n";
+    cout << "Graph from Test 2:\n";
+    g2.primMST();
+    g2.densePrimMST();
+    g2.adaptiveMST();
+
+    // Average degree ~190, edges listed by source, weights spanning 30 bits:
+    // the band where heap Prim beats Kruskal's 4-pass radix sort
+    Graph banded(1000);
+    mt19937 weights(10);
+    for (int u = 0; u < 1000; u++) {
+        for (int v = u + 1; v <= min(999, u + 100); v++)
+            banded.addEdge(u, v, (int)(weights() % 1000000000));
+    }
+    Graph::MSTEngine engine = banded.chooseMSTEngine();
+    long long heapWeight = 0, kruskalWeight = 0;
+    for (const Edge& edge : banded.computeMST(engine))
+        heapWeight += edge.weight;
+    for (const Edge& edge : banded.computeMST(Graph::MSTEngine::Kruskal))
+        kruskalWeight += edge.weight;
+    cout << "Banded graph (1000 vertices, each joined to the next 100): heap Prim chosen? "
+         << (engine == Graph::MSTEngine::PrimHeap ? "Yes" : "No")
+         << ", same weight as Kruskal? " << (heapWeight == kruskalWeight ? "Yes" : "No") << "\n";
 
     return 0;
 }
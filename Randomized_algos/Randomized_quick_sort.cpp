@@ -7,14 +7,38 @@
 // Randomized: Pick random pivot to avoid worst-case on sorted arrays
 // Time Complexity: O(n log n) average, O(n²) worst case
 // Space Complexity: O(log n) for recursion stack
+//
+// randomizedIntroSort is the production mode: three-way (Dutch national
+// flag) partitioning so runs of equal keys are finished in one pass,
+// recursion only into the smaller side, insertion sort for small ranges
+// and a heapsort fallback past 2*log2(n) levels: O(n log n) worst case
+// parallelRandomizedQuickSort splits the array into buckets with one
+// parallel sample-sort pass, then sorts them as tasks on a work-stealing
+// pool: each thread partitions its own ranges and idle threads steal
+//
+// Test 9 times the parallel sort for 1, 2, 4, ... threads. Build with
+// -DSORT_SWEEP_ELEMENTS=1000000000 to sweep at the 10^9 target (8 GB:
+// the array plus the scatter buffer)
 
 #include <iostream>
 #include <vector>
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
+#include <random>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <chrono>
 using namespace std;
 
+#ifndef SORT_SWEEP_ELEMENTS
+#define SORT_SWEEP_ELEMENTS 4000000
+#endif
+
 // ============================================================================
 // RANDOMIZED PARTITION
 // ============================================================================
@@ -73,6 +97,372 @@ void randomizedQuickSort(vector<int>& arr) {
     randomizedQuickSortUtil(arr, 0, arr.size() - 1);
 }
 
+// ============================================================================
+// THREE-WAY PARTITION (Dutch national flag)
+// ============================================================================
+
+// Partition arr[low..high] around a random pivot into
+// [low, lt) < pivot, [lt, gt] == pivot, (gt, high] > pivot
+// Keys equal to the pivot are never looked at again, so arrays with few
+// distinct values cost O(n) per distinct value instead of O(n^2).
+// random picks the pivot; nullptr uses rand() (not safe across threads)
+void threeWayPartition(vector<int>& arr, int low, int high, int& lt, int& gt,
+                       mt19937* random = nullptr) {
+    unsigned r = random != nullptr ? (unsigned)(*random)() : (unsigned)rand();
+    int pivot = arr[low + r % (unsigned)(high - low + 1)];
+    lt = low;
+    gt = high;
+    int i = low;
+
+    while (i <= gt) {
+        if (arr[i] < pivot)
+            swap(arr[lt++], arr[i++]);
+        else if (arr[i] > pivot)
+            swap(arr[i], arr[gt--]);
+        else
+            i++;
+    }
+}
+
+// ============================================================================
+// INTROSORT HELPERS
+// ============================================================================
+
+// Ranges this small are finished with insertion sort
+const int INSERTION_CUTOFF = 16;
+
+void insertionSort(vector<int>& arr, int low, int high) {
+    for (int i = low + 1; i <= high; i++) {
+        int key = arr[i];
+        int j = i - 1;
+        while (j >= low && arr[j] > key) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+// Heapsort of arr[low..high]: O(n log n) whatever the input
+void heapSortRange(vector<int>& arr, int low, int high) {
+    make_heap(arr.begin() + low, arr.begin() + high + 1);
+    sort_heap(arr.begin() + low, arr.begin() + high + 1);
+}
+
+// Sort arr[low..high]; depthLimit partitions are allowed before heapsort
+// takes over. Only the smaller side is recursed into, the larger one is
+// handled by the loop, so the stack holds at most log2(n) frames.
+void introSortUtil(vector<int>& arr, int low, int high, int depthLimit,
+                   mt19937* random = nullptr) {
+    while (high - low + 1 > INSERTION_CUTOFF) {
+        if (depthLimit == 0) {
+            heapSortRange(arr, low, high);
+            return;
+        }
+        depthLimit--;
+
+        int lt, gt;
+        threeWayPartition(arr, low, high, lt, gt, random);
+
+        if (lt - low < high - gt) {
+            introSortUtil(arr, low, lt - 1, depthLimit, random);
+            low = gt + 1;
+        } else {
+            introSortUtil(arr, gt + 1, high, depthLimit, random);
+            high = lt - 1;
+        }
+    }
+
+    insertionSort(arr, low, high);
+}
+
+// ============================================================================
+// RANDOMIZED INTROSORT WRAPPER FUNCTION
+// ============================================================================
+
+// Partition levels allowed before heapsort: 2 * floor(log2 n)
+int introDepthLimit(size_t n) {
+    int depthLimit = 0;
+    for (; n > 1; n >>= 1)
+        depthLimit += 2;
+    return depthLimit;
+}
+
+void randomizedIntroSort(vector<int>& arr) {
+    if (arr.size() < 2)
+        return;
+
+    int depthLimit = introDepthLimit(arr.size());
+
+    introSortUtil(arr, 0, (int)arr.size() - 1, depthLimit);
+}
+
+// ============================================================================
+// WORK-STEALING SORT POOL
+// ============================================================================
+
+// A range still to be sorted
+struct SortTask {
+    int low;
+    int high;
+    int depthLimit;
+};
+
+// Every thread owns a deque of tasks and its own random generator. It
+// pushes and pops at the back of its own deque (newest, smallest ranges
+// first); a thread with nothing left steals from the front of another's
+// deque, where the oldest and largest ranges are. Each deque has its own
+// lock, so threads only contend when stealing from the same victim, and a
+// thief skips empty deques without locking them. A thread that finds no
+// task at all sleeps on a condition variable until a task is pushed or
+// the sort is done, instead of spinning.
+class SortTaskPool {
+private:
+    struct Worker {
+        mutex lock;
+        deque<SortTask> tasks;
+        atomic<int> queued{0};               // tasks.size(), readable without the lock
+        mt19937 random;
+    };
+
+    vector<int>& arr;
+    int grain;                               // Ranges up to this size are not split
+    vector<unique_ptr<Worker>> workers;
+    atomic<long long> pending;               // Tasks pushed but not finished
+    atomic<long long> queued;                // Tasks sitting in any deque
+
+    mutex idleLock;
+    condition_variable wake;                 // A task was pushed, or pending hit 0
+    atomic<int> sleeping;                    // Threads waiting on wake
+
+    void push(int self, const SortTask& task) {
+        pending++;
+        {
+            Worker& me = *workers[self];
+            lock_guard<mutex> guard(me.lock);
+            me.tasks.push_back(task);
+            me.queued++;
+        }
+        queued++;
+
+        // A sleeper registers before it re-checks queued, so either it
+        // sees this task or this thread sees it sleeping
+        if (sleeping.load() > 0) {
+            lock_guard<mutex> guard(idleLock);
+            wake.notify_one();
+        }
+    }
+
+    bool popOwn(int self, SortTask& task) {
+        Worker& me = *workers[self];
+        if (me.queued.load() == 0)
+            return false;
+        lock_guard<mutex> guard(me.lock);
+        if (me.tasks.empty())
+            return false;
+        task = me.tasks.back();
+        me.tasks.pop_back();
+        me.queued--;
+        queued--;
+        return true;
+    }
+
+    bool steal(int self, SortTask& task) {
+        int n = (int)workers.size();
+        for (int k = 1; k < n; k++) {
+            Worker& victim = *workers[(self + k) % n];
+            if (victim.queued.load() == 0)
+                continue;
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                victim.queued--;
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Sleep until some deque has a task; false once everything is sorted
+    bool waitForWork() {
+        unique_lock<mutex> guard(idleLock);
+        sleeping++;
+        wake.wait(guard, [this]() { return pending.load() == 0 || queued.load() > 0; });
+        sleeping--;
+        return pending.load() > 0;
+    }
+
+    // Partition until the range is small, handing the smaller side of
+    // every split to the deque so idle threads can take it
+    void process(int self, SortTask task) {
+        mt19937& random = workers[self]->random;
+        int low = task.low, high = task.high, depthLimit = task.depthLimit;
+
+        while (high - low + 1 > grain) {
+            if (depthLimit == 0) {
+                heapSortRange(arr, low, high);
+                return;
+            }
+            depthLimit--;
+
+            int lt, gt;
+            threeWayPartition(arr, low, high, lt, gt, &random);
+
+            if (lt - low < high - gt) {
+                if (low < lt - 1)
+                    push(self, {low, lt - 1, depthLimit});
+                low = gt + 1;
+            } else {
+                if (gt + 1 < high)
+                    push(self, {gt + 1, high, depthLimit});
+                high = lt - 1;
+            }
+        }
+
+        if (low < high)
+            introSortUtil(arr, low, high, depthLimit, &random);
+    }
+
+    void run(int self) {
+        for (;;) {
+            SortTask task;
+            if (popOwn(self, task) || steal(self, task)) {
+                process(self, task);
+                // Only after its subtasks were pushed; the last one
+                // releases every sleeping thread
+                if (--pending == 0) {
+                    lock_guard<mutex> guard(idleLock);
+                    wake.notify_all();
+                }
+            } else if (!waitForWork()) {
+                return;
+            }
+        }
+    }
+
+public:
+    SortTaskPool(vector<int>& a, int threadCount, int grainSize, unsigned seed)
+        : arr(a), grain(grainSize), pending(0), queued(0), sleeping(0) {
+        for (int t = 0; t < threadCount; t++) {
+            workers.emplace_back(new Worker());
+            workers[t]->random.seed(seed + 0x9e3779b9u * (unsigned)(t + 1));
+        }
+    }
+
+    // Queue a range on a thread's deque (before run)
+    void add(int thread, const SortTask& task) {
+        push(thread % (int)workers.size(), task);
+    }
+
+    // Sort every queued range; returns when all tasks are done
+    void run() {
+        vector<thread> pool;
+        for (int t = 1; t < (int)workers.size(); t++)
+            pool.emplace_back([this, t]() { run(t); });
+        run(0);
+        for (thread& th : pool)
+            th.join();
+    }
+};
+
+// ============================================================================
+// PARALLEL RANDOMIZED QUICK SORT
+// ============================================================================
+
+// Run f(thread, begin, end) on threadCount threads over [0, count)
+template <typename F>
+void parallelFor(size_t count, int threadCount, F f) {
+    vector<thread> pool;
+    for (int t = 1; t < threadCount; t++)
+        pool.emplace_back(f, t, count * t / threadCount, count * (t + 1) / threadCount);
+    f(0, (size_t)0, count / threadCount);
+    for (thread& th : pool)
+        th.join();
+}
+
+// 1. Sample sort step (parallel, replaces the serial first partition):
+//    pick 4 buckets per thread from a sorted random sample, count bucket
+//    sizes per thread slice, then every thread scatters its own slice into
+//    an uninitialised buffer that is copied back in parallel
+// 2. Every bucket becomes a task on the work-stealing pool; tasks above
+//    grainSize elements are partitioned further into new tasks
+void parallelRandomizedQuickSort(vector<int>& arr, int threadCount = 0,
+                                 int grainSize = 1 << 14, unsigned seed = 1) {
+    if (threadCount <= 0)
+        threadCount = (int)max(1u, thread::hardware_concurrency());
+    size_t n = arr.size();
+    if (n < 2)
+        return;
+
+    // Too small to be worth the sampling pass
+    if (threadCount == 1 || n <= (size_t)grainSize * 2) {
+        randomizedIntroSort(arr);
+        return;
+    }
+
+    // Step 1a: splitters from a sorted random sample
+    const int OVERSAMPLE = 32;
+    int buckets = threadCount * 4;
+    mt19937 random(seed);
+    vector<int> sample(buckets * OVERSAMPLE);
+    for (int& x : sample)
+        x = arr[random() % n];
+    sort(sample.begin(), sample.end());
+
+    vector<int> splitters(buckets - 1);
+    for (int b = 0; b < buckets - 1; b++)
+        splitters[b] = sample[(b + 1) * OVERSAMPLE];
+
+    // Bucket b holds keys in (splitters[b - 1], splitters[b]]
+    auto bucketOf = [&splitters](int x) {
+        return (int)(lower_bound(splitters.begin(), splitters.end(), x) - splitters.begin());
+    };
+
+    // Step 1b: per-thread bucket counts, turned into scatter offsets
+    vector<vector<size_t>> offset(threadCount, vector<size_t>(buckets, 0));
+    parallelFor(n, threadCount, [&](int t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            offset[t][bucketOf(arr[i])]++;
+    });
+
+    vector<size_t> bucketStart(buckets + 1, 0);
+    size_t position = 0;
+    for (int b = 0; b < buckets; b++) {
+        bucketStart[b] = position;
+        for (int t = 0; t < threadCount; t++) {
+            size_t count = offset[t][b];
+            offset[t][b] = position;
+            position += count;
+        }
+    }
+    bucketStart[buckets] = n;
+
+    // Step 1c: scatter, then copy the bucketed array back. The buffer is
+    // left uninitialised (a vector would zero-fill and first-touch all n
+    // ints on this thread), so every page is first touched by the thread
+    // scattering into it
+    unique_ptr<int[]> buffer(new int[n]);
+    parallelFor(n, threadCount, [&](int t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            buffer[offset[t][bucketOf(arr[i])]++] = arr[i];
+    });
+    parallelFor(n, threadCount, [&](int, size_t begin, size_t end) {
+        copy(buffer.get() + begin, buffer.get() + end, arr.begin() + begin);
+    });
+    buffer.reset();
+
+    // Step 2: sort the buckets on the work-stealing pool
+    SortTaskPool pool(arr, threadCount, grainSize, seed);
+    for (int b = 0; b < buckets; b++) {
+        size_t begin = bucketStart[b], end = bucketStart[b + 1];
+        if (end - begin > 1)
+            pool.add(b, {(int)begin, (int)end - 1, introDepthLimit(end - begin)});
+    }
+    pool.run();
+}
+
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
@@ -155,7 +545,65 @@ int main() {
 
     cout << "After quick sort:           ";
     printArray(arr5);
-    cout << "Is sorted? " << (isSorted(arr5) ? "Yes" : "No") << "\n";
+    cout << "Is sorted? " << (isSorted(arr5) ? "Yes" : "No") << "\n\n";
+
+    // Test case 6: Production mode on the duplicates array
+    vector<int> arr6 = {5, 2, 8, 2, 9, 1, 5, 5};
+    cout << "Test 6 - Introsort mode:    ";
+    printArray(arr6);
+
+    randomizedIntroSort(arr6);
+
+    cout << "After introsort:            ";
+    printArray(arr6);
+    cout << "Is sorted? " << (isSorted(arr6) ? "Yes" : "No") << "\n\n";
+
+    // Test case 7: Test 4 taken to a million elements (only 3 distinct
+    // values: Lomuto partitioning would go quadratic here)
+    vector<int> arr7(1000000);
+    for (size_t i = 0; i < arr7.size(); i++)
+        arr7[i] = rand() % 3;
+    cout << "Test 7 - Introsort on 1000000 elements with 3 distinct values\n";
+
+    clock_t start = clock();
+    randomizedIntroSort(arr7);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    cout << "Is sorted? " << (isSorted(arr7) ? "Yes" : "No")
+         << " (" << elapsed * 1000 << " ms)\n\n";
+
+    // Test case 8: Parallel sort of 4 million random values
+    vector<int> arr8(4000000);
+    for (size_t i = 0; i < arr8.size(); i++)
+        arr8[i] = rand();
+    cout << "Test 8 - Parallel quick sort (4 threads) on " << arr8.size() << " elements\n";
+
+    parallelRandomizedQuickSort(arr8, 4);
+
+    cout << "Is sorted? " << (isSorted(arr8) ? "Yes" : "No") << "\n\n";
+
+    // Test case 9: Thread-count sweep on the same random input
+    size_t sweepSize = SORT_SWEEP_ELEMENTS;
+    int maxThreads = (int)max(8u, thread::hardware_concurrency());
+    cout << "Test 9 - Thread-count sweep on " << sweepSize << " elements ("
+         << thread::hardware_concurrency() << " hardware threads)\n";
+    if (thread::hardware_concurrency() <= 1)
+        cout << "Only one hardware thread: extra threads can only add overhead here\n";
+
+    vector<int> arr9(sweepSize);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        mt19937 fill(9);
+        for (int& x : arr9)
+            x = (int)(fill() >> 1);
+
+        // Wall time: clock() would add up the CPU time of every thread
+        auto sweepStart = chrono::steady_clock::now();
+        parallelRandomizedQuickSort(arr9, threads);
+        double wall = chrono::duration<double>(chrono::steady_clock::now() - sweepStart).count();
+
+        cout << threads << " threads: sorted? " << (isSorted(arr9) ? "Yes" : "No")
+             << " (" << wall * 1000 << " ms)\n";
+    }
 
     return 0;
 }
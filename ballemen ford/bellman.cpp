@@ -7,94 +7,1061 @@
 // Detects negative weight cycles
 // Time Complexity: O(V * E) where V = vertices, E = edges
 // Space Complexity: O(V)
+//
+// bellmanFord stops as soon as a full pass changes nothing
+// bellmanFordYen sweeps edges in alternating order over a random vertex
+// numbering (Yen's improvement: at most ceil(V/2) passes)
+// bellmanFordSPFA only relaxes edges out of vertices whose distance changed
+// (queue-based, "Shortest Path Faster Algorithm")
+// bellmanFordParallel splits every pass over the edges across threads
+// findNegativeCycle keeps the shortest-path tree and stops (returning the
+// cycle) as soon as a relaxation would make a vertex its own ancestor
+// johnsonAllPairs: one Bellman-Ford for potentials, then Dijkstra from
+// every source in parallel (O(V * E log V) instead of O(V^2 * E))
+// trackShortestPaths keeps its tree so later addEdge / updateEdge calls only
+// repair the part of it they affect
+//
+// BasicGraph<W> works with int, long long, float or double weights (Graph is
+// BasicGraph<int>). Integer sums saturate instead of wrapping around, and a
+// distance that leaves the weight type's range is reported as an overflow
+// (never as unreachable). Edges are kept as separate source / destination /
+// weight arrays sorted by source; with AVX2 each pass checks 8 int or float
+// edges at a time.
 
 #include <iostream>
 #include <vector>
 #include <climits>
+#include <limits>
+#include <cmath>
+#include <type_traits>
 #include <algorithm>
+#include <queue>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 using namespace std;
 
 // ============================================================================
-// EDGE STRUCTURE
+// WEIGHT ARITHMETIC
 // ============================================================================
 
-struct Edge {
-    int source;      // Starting vertex of edge
-    int destination; // Ending vertex of edge
-    int weight;      // Weight of the edge
+// infinity() marks an unreachable vertex. add() saturates for integer
+// types: a sum above the range becomes infinity (never an improvement) and
+// one below it clamps to the lowest value, so distances never wrap around.
+// Floating-point sums already saturate to +-inf on their own. A saturated
+// sum is not a distance: overflows() tells the algorithms when one would
+// have been an improvement, so they report an overflow instead.
+template <typename W>
+struct WeightTraits {
+    static_assert(is_arithmetic<W>::value, "edge weights must be numbers");
+
+    // Type wide enough for reweighted sums and all-pairs results
+    typedef typename conditional<is_floating_point<W>::value, double, long long>::type Wide;
+
+    static constexpr W infinity() {
+        return numeric_limits<W>::has_infinity ? numeric_limits<W>::infinity()
+                                               : numeric_limits<W>::max();
+    }
+
+    static W add(W a, W b) {
+        if constexpr (is_floating_point<W>::value)
+            return a + b;
+        if (b > 0 && a > numeric_limits<W>::max() - b)
+            return infinity();
+        if (b < 0 && a < numeric_limits<W>::lowest() - b)
+            return numeric_limits<W>::lowest();
+        return a + b;
+    }
+
+    // True when the exact a + b is out of range and would still beat
+    // current (a finite): the shortest distance itself does not fit in W
+    static bool overflows(W a, W b, W current) {
+        if constexpr (is_floating_point<W>::value) {
+            W sum = a + b;
+            return isinf(sum) && !isinf(b) && (sum < 0 || current == infinity());
+        } else {
+            if (b > 0 && a > numeric_limits<W>::max() - b)
+                return current == infinity();
+            return b < 0 && a < numeric_limits<W>::lowest() - b;
+        }
+    }
+};
+
+// ============================================================================
+// EDGE ARRAYS (Structure of arrays)
+// ============================================================================
+
+// Edge i is source[i] -> destination[i] with weight[i]. A pass streams
+// through three dense arrays, and 8 consecutive edges load straight into
+// one AVX2 register per field.
+template <typename W>
+struct EdgeArrays {
+    vector<int> source;      // Starting vertex of each edge
+    vector<int> destination; // Ending vertex of each edge
+    vector<W> weight;        // Weight of each edge
+
+    size_t size() const {
+        return source.size();
+    }
+
+    void push(int src, int dest, W w) {
+        source.push_back(src);
+        destination.push_back(dest);
+        weight.push_back(w);
+    }
+};
+
+#if defined(__AVX2__)
+// Bit k is set when edge i+k may relax: dist[src] + w < dist[dst] on the
+// gathered distances. Integer lanes whose sum overflows are flagged too so
+// the scalar saturating code decides them.
+inline unsigned relaxCandidates(const int* distance, const int* source,
+                                const int* destination, const int* weight) {
+    __m256i src = _mm256_loadu_si256((const __m256i*)source);
+    __m256i dst = _mm256_loadu_si256((const __m256i*)destination);
+    __m256i w = _mm256_loadu_si256((const __m256i*)weight);
+    __m256i du = _mm256_i32gather_epi32(distance, src, 4);
+    __m256i dv = _mm256_i32gather_epi32(distance, dst, 4);
+
+    __m256i candidate = _mm256_add_epi32(du, w);
+    __m256i overflow = _mm256_and_si256(_mm256_xor_si256(du, candidate),
+                                        _mm256_xor_si256(w, candidate));
+    overflow = _mm256_srai_epi32(overflow, 31);
+    __m256i better = _mm256_or_si256(_mm256_cmpgt_epi32(dv, candidate), overflow);
+    __m256i unreachable = _mm256_cmpeq_epi32(du, _mm256_set1_epi32(INT_MAX));
+
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(unreachable, better)));
+}
+
+inline unsigned relaxCandidates(const float* distance, const int* source,
+                                const int* destination, const float* weight) {
+    __m256i src = _mm256_loadu_si256((const __m256i*)source);
+    __m256i dst = _mm256_loadu_si256((const __m256i*)destination);
+    __m256 du = _mm256_i32gather_ps(distance, src, 4);
+    __m256 dv = _mm256_i32gather_ps(distance, dst, 4);
+
+    // inf + w stays inf and never compares less, so no reachability test
+    __m256 candidate = _mm256_add_ps(du, _mm256_loadu_ps(weight));
+    return (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(candidate, dv, _CMP_LT_OQ));
+}
+#endif
+
+// ============================================================================
+// ALL-PAIRS DISTANCE MATRIX
+// ============================================================================
+
+// Row-major V x V matrix in one allocation; UNREACHABLE when no path exists
+template <typename D>
+struct BasicDistanceMatrix {
+    static constexpr D UNREACHABLE = WeightTraits<D>::infinity();
+
+    int vertices = 0;
+    vector<D> data;
+
+    D at(int from, int to) const {
+        return data[(size_t)from * vertices + to];
+    }
+};
+
+typedef BasicDistanceMatrix<long long> DistanceMatrix;
+
+// ============================================================================
+// PASS BARRIER (Threads wait here until all of them finished a pass)
+// ============================================================================
+
+class PassBarrier {
+private:
+    mutex lock;
+    condition_variable allArrived;
+    int count;               // Threads taking part
+    int waiting;             // Threads arrived in the current generation
+    unsigned generation;     // Bumped each time everyone has arrived
+
+public:
+    explicit PassBarrier(int n) : count(n), waiting(0), generation(0) {}
+
+    void wait() {
+        unique_lock<mutex> guard(lock);
+        unsigned arrivedIn = generation;
+
+        if (++waiting == count) {
+            waiting = 0;
+            generation++;
+            allArrived.notify_all();
+        } else {
+            allArrived.wait(guard, [this, arrivedIn]() { return generation != arrivedIn; });
+        }
+    }
+};
+
+// ============================================================================
+// SHORTEST-PATH TREE WITH SUBTREE DISASSEMBLY (Tarjan)
+// ============================================================================
+// Queue-based Bellman-Ford that maintains the tree of predecessors.
+// When dist[v] improves through edge u->v, every vertex below v in the tree
+// has a stale distance, so the whole subtree is detached and its vertices
+// are not scanned until they improve again. If u itself is below v, the
+// edge u->v closes a cycle whose weight is negative (dist[v] just improved
+// by going around it), so the cycle is reported immediately instead of
+// after V-1 full passes.
+//
+// The tree is stored as a preorder "thread" (doubly linked list) plus the
+// depth of each vertex: the subtree of v is v followed by every vertex
+// after it in preorder whose depth is greater than depth[v].
+
+template <typename W>
+class ShortestPathTree {
+public:
+    vector<W> distance;      // WeightTraits<W>::infinity() = unreachable
+    vector<int> parent;      // Predecessor on the shortest path, -1 if none
+    vector<int> parentEdge;  // Index of the tree edge into each vertex, -1 if none
+
+private:
+    int vertices;
+    int root;                // Virtual root (index vertices) above the source(s)
+    vector<int> next, prev;  // Preorder thread, including the root
+    vector<int> depth;
+    vector<bool> inTree;     // False for unreached or detached vertices
+    vector<bool> queued;
+    queue<int> pending;
+
+    void unlink(int v) {
+        next[prev[v]] = next[v];
+        if (next[v] != -1)
+            prev[next[v]] = prev[v];
+    }
+
+    // Make v a leaf child of u (placed right after u in preorder)
+    void attach(int u, int v, int edgeIndex) {
+        parent[v] = (u == root) ? -1 : u;
+        parentEdge[v] = edgeIndex;
+        depth[v] = depth[u] + 1;
+        prev[v] = u;
+        next[v] = next[u];
+        if (next[u] != -1)
+            prev[next[u]] = v;
+        next[u] = v;
+        inTree[v] = true;
+    }
+
+    // Detach everything strictly below v; true if u was found there
+    bool disassemble(int v, int u) {
+        int x = next[v];
+        while (x != -1 && depth[x] > depth[v]) {
+            if (x == u)
+                return true;
+            inTree[x] = false;
+            x = next[x];
+        }
+
+        // Splice the detached block out of the thread in one step
+        next[v] = x;
+        if (x != -1)
+            prev[x] = v;
+        return false;
+    }
+
+    // Tree path v -> ... -> u, which the edge u -> v closes into a cycle
+    vector<int> cycleThrough(int v, int u) {
+        vector<int> cycle;
+        for (int x = u; x != v; x = parent[x])
+            cycle.push_back(x);
+        cycle.push_back(v);
+        reverse(cycle.begin(), cycle.end());
+        return cycle;
+    }
+
+public:
+    // Start from one source, or from every vertex at distance 0 when
+    // source is -1 (finds negative cycles anywhere in the graph)
+    void reset(int n, int source) {
+        vertices = n;
+        root = n;
+        distance.assign(n, WeightTraits<W>::infinity());
+        parent.assign(n, -1);
+        parentEdge.assign(n, -1);
+        next.assign(n + 1, -1);
+        prev.assign(n + 1, -1);
+        depth.assign(n + 1, 0);
+        inTree.assign(n + 1, false);
+        queued.assign(n, false);
+        pending = queue<int>();
+        inTree[root] = true;
+
+        for (int v = (source == -1 ? n - 1 : source); v >= (source == -1 ? 0 : source); v--) {
+            distance[v] = 0;
+            attach(root, v, -1);
+            push(v);
+        }
+    }
+
+    void push(int v) {
+        if (!queued[v]) {
+            queued[v] = true;
+            pending.push(v);
+        }
+    }
+
+    bool contains(int v) const {
+        return inTree[v];
+    }
+
+    // Remove v and its whole subtree from the tree and reset their distances
+    // Returns the removed vertices (v first)
+    vector<int> detachSubtree(int v) {
+        vector<int> removed(1, v);
+        int x = next[v];
+        while (x != -1 && depth[x] > depth[v]) {
+            removed.push_back(x);
+            x = next[x];
+        }
+
+        next[prev[v]] = x;
+        if (x != -1)
+            prev[x] = prev[v];
+
+        for (int r : removed) {
+            distance[r] = WeightTraits<W>::infinity();
+            parent[r] = -1;
+            parentEdge[r] = -1;
+            inTree[r] = false;
+        }
+        return removed;
+    }
+
+    // Try to improve dist[v] through edge u -> v (u must be in the tree)
+    // Returns the negative cycle closed by this edge, or an empty vector
+    vector<int> relax(int u, int v, W weight, int edgeIndex) {
+        W candidate = WeightTraits<W>::add(distance[u], weight);
+        if (!(candidate < distance[v]))
+            return vector<int>();
+
+        distance[v] = candidate;
+
+        if (u == v)
+            return vector<int>(1, v);               // Negative self-loop
+
+        if (inTree[v]) {
+            if (disassemble(v, u))
+                return cycleThrough(v, u);
+            unlink(v);
+        }
+
+        attach(u, v, edgeIndex);
+        push(v);
+        return vector<int>();
+    }
+
+    // Run the queue until distances settle or a negative cycle appears
+    template <typename G>
+    vector<int> propagate(const G& graph) {
+        vector<int> cycle;
+        while (!pending.empty() && cycle.empty()) {
+            int u = pending.front();
+            pending.pop();
+            queued[u] = false;
+
+            // Detached after it was queued: its distance is stale
+            if (!inTree[u])
+                continue;
+
+            graph.forEachOutEdge(u, [&](int index, int v, W weight) {
+                cycle = relax(u, v, weight, index);
+                return cycle.empty();
+            });
+        }
+        return cycle;
+    }
 };
 
 // ============================================================================
 // BELLMAN-FORD ALGORITHM
 // ============================================================================
 
-class Graph {
+template <typename W>
+class BasicGraph {
+public:
+    typedef WeightTraits<W> Traits;
+    typedef typename Traits::Wide Wide;
+
 private:
     int vertices;           // Number of vertices
-    vector<Edge> edges;     // List of all edges
+
+    // All edges. The first sortedCount are grouped by source vertex:
+    // vertex u's edges are [firstEdge[u], firstEdge[u + 1]). Edges added
+    // after that are listed per source in pendingOut until the next full
+    // run re-sorts them in (incremental updates never wait for a re-sort).
+    EdgeArrays<W> edges;
+    size_t sortedCount = 0;
+    vector<int> firstEdge;
+    vector<vector<int>> pendingOut;
+    vector<vector<int>> incoming;    // Incoming edge indices per vertex
+
+    // Result of the last trackShortestPaths, kept up to date by edge changes
+    ShortestPathTree<W> tracked;
+    int trackedSource = -1;          // -1 when nothing is tracked
+    vector<int> trackedCycle;        // Non-empty once a negative cycle appeared
+    mutable bool overflowChecked = false;    // trackedOverflow is up to date
+    mutable bool trackedOverflow = false;
+
+    // Stable counting sort of every edge by source (edge indices change;
+    // the tracked tree's edge indices are remapped)
+    void layoutEdges() {
+        if (sortedCount == edges.size())
+            return;
+
+        size_t count = edges.size();
+        firstEdge.assign(vertices + 1, 0);
+        for (size_t i = 0; i < count; i++)
+            firstEdge[edges.source[i] + 1]++;
+        for (int u = 0; u < vertices; u++)
+            firstEdge[u + 1] += firstEdge[u];
+
+        vector<int> position(firstEdge.begin(), firstEdge.end() - 1);
+        vector<int> newIndex(count);
+        EdgeArrays<W> sorted;
+        sorted.source.resize(count);
+        sorted.destination.resize(count);
+        sorted.weight.resize(count);
+
+        for (size_t i = 0; i < count; i++) {
+            int p = position[edges.source[i]]++;
+            newIndex[i] = p;
+            sorted.source[p] = edges.source[i];
+            sorted.destination[p] = edges.destination[i];
+            sorted.weight[p] = edges.weight[i];
+        }
+        edges = move(sorted);
+        sortedCount = count;
+
+        for (vector<int>& list : pendingOut)
+            list.clear();
+        for (vector<int>& list : incoming)
+            list.clear();
+        for (size_t i = 0; i < count; i++)
+            incoming[edges.destination[i]].push_back((int)i);
+
+        if (trackedSource != -1) {
+            for (int& e : tracked.parentEdge) {
+                if (e != -1)
+                    e = newIndex[e];
+            }
+        }
+    }
+
+    // Scalar relaxation of list edge i; true if it lowered a distance
+    bool relaxEdge(vector<W>& distance, const EdgeArrays<W>& list, size_t i) {
+        W du = distance[list.source[i]];
+        if (du == Traits::infinity())
+            return false;
+
+        W candidate = Traits::add(du, list.weight[i]);
+        if (candidate < distance[list.destination[i]]) {
+            distance[list.destination[i]] = candidate;
+            return true;
+        }
+        return false;
+    }
+
+    // One in-order pass over list; true if anything changed. The AVX2
+    // kernel only filters: it checks a block of 8 edges on distances
+    // gathered at the start of the block. Lanes before the first real
+    // improvement saw current values, and everything after it is redone
+    // in scalar, so the result is exactly that of the plain loop.
+    bool relaxPass(vector<W>& distance, const EdgeArrays<W>& list) {
+        size_t count = list.size();
+        size_t i = 0;
+        bool changed = false;
+
+#if defined(__AVX2__)
+        if constexpr (is_same<W, int>::value || is_same<W, float>::value) {
+            for (; i + 8 <= count; i += 8) {
+                unsigned lanes = relaxCandidates(distance.data(), &list.source[i],
+                                                 &list.destination[i], &list.weight[i]);
+                while (lanes != 0) {
+                    size_t k = i + __builtin_ctz(lanes);
+                    lanes &= lanes - 1;
+                    if (relaxEdge(distance, list, k)) {
+                        // Later lanes may read the distance just lowered
+                        for (k++; k < i + 8; k++)
+                            relaxEdge(distance, list, k);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+            changed |= relaxEdge(distance, list, i);
+        return changed;
+    }
+
+    // Any edge still relaxable: only possible with a negative cycle once
+    // the pass limit is reached
+    bool hasRelaxableEdge(const vector<W>& distance) const {
+        for (size_t i = 0; i < edges.size(); i++) {
+            W du = distance[edges.source[i]];
+            if (du != Traits::infinity() &&
+                Traits::add(du, edges.weight[i]) < distance[edges.destination[i]])
+                return true;
+        }
+        return false;
+    }
+
+    // Once distances settled, an edge whose exact sum would still improve
+    // its head means some shortest distance left W's range: add() saturated
+    // it to infinity (reading as unreachable) or clamped it to the lowest
+    // value, and the distances downstream of it are wrong as well
+    bool hasOverflowedDistance(const vector<W>& distance) const {
+        for (size_t i = 0; i < edges.size(); i++) {
+            W du = distance[edges.source[i]];
+            if (du != Traits::infinity() &&
+                Traits::overflows(du, edges.weight[i], distance[edges.destination[i]]))
+                return true;
+        }
+        return false;
+    }
+
+    // Edge index e got cheaper (or was just added): relax it and let the
+    // improvement flow through the tracked tree
+    void propagateDecrease(int e) {
+        if (!tracked.contains(edges.source[e]))
+            return;
+
+        trackedCycle = tracked.relax(edges.source[e], edges.destination[e], edges.weight[e], e);
+        if (trackedCycle.empty())
+            trackedCycle = tracked.propagate(*this);
+    }
+
+    // Tree edge e got more expensive: every vertex under its head may now
+    // be worse off. Detach that subtree, rebuild each detached vertex from
+    // its incoming edges out of the rest of the tree, then propagate.
+    void propagateIncrease(int e) {
+        vector<int> affected = tracked.detachSubtree(edges.destination[e]);
+
+        for (int v : affected) {
+            for (int index : incoming[v]) {
+                if (tracked.contains(edges.source[index]))
+                    tracked.relax(edges.source[index], v, edges.weight[index], index);
+            }
+        }
+
+        trackedCycle = tracked.propagate(*this);
+    }
+
+    // Print distances, or the negative cycle / overflow message
+    void printResult(int source, const vector<W>& distance, bool hasNegativeCycle) {
+        if (hasNegativeCycle) {
+            cout << "Graph contains a negative weight cycle!\n";
+            return;
+        }
+        if (hasOverflowedDistance(distance)) {
+            cout << "Distances from source " << source
+                 << " overflow the weight type (use a wider one)\n";
+            return;
+        }
+
+        cout << "Vertex distances from source " << source << ":\n";
+        for (int i = 0; i < vertices; i++) {
+            if (distance[i] == Traits::infinity())
+                cout << "Vertex " << i << ": INF (unreachable)\n";
+            else
+                cout << "Vertex " << i << ": " << distance[i] << "\n";
+        }
+    }
 
 public:
-    Graph(int v) : vertices(v) {}
+    BasicGraph(int v)
+        : vertices(v), firstEdge(v + 1, 0), pendingOut(v), incoming(v) {}
 
     // Add an edge to the graph
-    void addEdge(int src, int dest, int weight) {
-        Edge edge = {src, dest, weight};
-        edges.push_back(edge);
+    void addEdge(int src, int dest, W weight) {
+        edges.push(src, dest, weight);
+        int e = (int)edges.size() - 1;
+        pendingOut[src].push_back(e);
+        incoming[dest].push_back(e);
+        overflowChecked = false;
+
+        // A new edge can only shorten paths
+        if (trackedSource != -1) {
+            if (trackedCycle.empty())
+                propagateDecrease(e);
+            else
+                trackShortestPaths(trackedSource);
+        }
+    }
+
+    // Call f(edgeIndex, destination, weight) for each edge out of u, in
+    // insertion order; stops early once f returns false
+    template <typename F>
+    void forEachOutEdge(int u, F f) const {
+        for (int e = firstEdge[u]; e < firstEdge[u + 1]; e++) {
+            if (!f(e, edges.destination[e], edges.weight[e]))
+                return;
+        }
+        for (int e : pendingOut[u]) {
+            if (!f(e, edges.destination[e], edges.weight[e]))
+                return;
+        }
+    }
+
+    // Change the weight of edge src -> dest (the first one, if there are
+    // parallel edges). Tracked shortest paths are repaired incrementally.
+    // Returns false if there is no such edge.
+    bool updateEdge(int src, int dest, W newWeight) {
+        int e = -1;
+        forEachOutEdge(src, [&](int index, int v, W) {
+            if (v == dest)
+                e = index;
+            return e == -1;
+        });
+        if (e == -1)
+            return false;
+
+        W oldWeight = edges.weight[e];
+        edges.weight[e] = newWeight;
+        overflowChecked = false;
+
+        if (trackedSource == -1 || newWeight == oldWeight)
+            return true;
+
+        if (!trackedCycle.empty()) {
+            // The cycle may have been broken: start over
+            trackShortestPaths(trackedSource);
+        } else if (newWeight < oldWeight) {
+            propagateDecrease(e);
+        } else if (tracked.parentEdge[dest] == e) {
+            propagateIncrease(e);
+        }
+        // A heavier non-tree edge changes nothing
+        return true;
+    }
+
+    // Compute shortest paths from source and keep them for incremental updates
+    void trackShortestPaths(int source) {
+        layoutEdges();
+
+        trackedSource = source;
+        tracked.reset(vertices, source);
+        trackedCycle = tracked.propagate(*this);
+        overflowChecked = false;
+    }
+
+    // Print the tracked distances (or the negative cycle)
+    void printTrackedPaths() {
+        if (trackedSource == -1) {
+            cout << "No shortest paths are being tracked\n";
+            return;
+        }
+
+        if (!trackedCycle.empty()) {
+            cout << "Graph contains a negative weight cycle: ";
+            for (int v : trackedCycle)
+                cout << v << " -> ";
+            cout << trackedCycle[0] << "\n";
+            return;
+        }
+
+        printResult(trackedSource, tracked.distance, false);
+    }
+
+    // Tracked distance to v (infinity if unreachable or tracking is off).
+    // Throws overflow_error if the tracked distances do not fit in W; the
+    // check scans the edges once after each change.
+    W trackedDistance(int v) const {
+        if (trackedSource == -1 || !trackedCycle.empty())
+            return Traits::infinity();
+
+        if (!overflowChecked) {
+            trackedOverflow = hasOverflowedDistance(tracked.distance);
+            overflowChecked = true;
+        }
+        if (trackedOverflow)
+            throw overflow_error("tracked shortest distances overflow the weight type");
+        return tracked.distance[v];
     }
 
     // Main Bellman-Ford algorithm
     void bellmanFord(int source) {
+        layoutEdges();
+
         // Step 1: Initialize distances array
         // Set all distances to infinity except source (0)
-        vector<int> distance(vertices, INT_MAX);
+        vector<W> distance(vertices, Traits::infinity());
         distance[source] = 0;
 
         // Step 2: Relax edges (V-1) times
         // Relaxation: if path through current edge is shorter, update distance
-        for (int i = 0; i < vertices - 1; i++) {
-            // Check each edge
-            for (const Edge& edge : edges) {
-                int u = edge.source;
-                int v = edge.destination;
-                int weight = edge.weight;
-
-                // If source is reachable and path through this edge is shorter
-                if (distance[u] != INT_MAX && distance[u] + weight < distance[v]) {
-                    distance[v] = distance[u] + weight;
-                }
-            }
-        }
+        // A pass that changes nothing means every distance is final
+        bool converged = false;
+        for (int i = 0; i < vertices - 1 && !converged; i++)
+            converged = !relaxPass(distance, edges);
 
         // Step 3: Check for negative weight cycles
         // If we can still relax an edge, there's a negative cycle
+        // (skipped after an early stop: nothing was relaxable then)
+        bool hasNegativeCycle = !converged && hasRelaxableEdge(distance);
+
+        // Step 4: Print results
+        printResult(source, distance, hasNegativeCycle);
+    }
+
+    // Bellman-Ford with Yen's improvement
+    // Vertices are relabelled by a random permutation. Edges to a higher
+    // label form a DAG, and so do edges to a lower label, so a pass relaxes
+    // the first set in increasing label order of the source, then the second
+    // in decreasing order. One pass settles a whole ascending run plus a
+    // whole descending run of a shortest path, so ceil(V/2) passes suffice
+    // instead of V-1, and with random labels about V/3 are needed on
+    // average in the worst case. Returns the number of passes run
+    // (including the final one that found nothing to change).
+    int bellmanFordYen(int source, unsigned seed = mt19937::default_seed) {
+        layoutEdges();
+
+        vector<int> order(vertices), label(vertices);
+        for (int v = 0; v < vertices; v++)
+            order[v] = v;
+        mt19937 random(seed);
+        shuffle(order.begin(), order.end(), random);
+        for (int i = 0; i < vertices; i++)
+            label[order[i]] = i;
+
+        // Self-loops go with the ascending edges: a negative one keeps the
+        // passes going until the cycle check below finds it
+        EdgeArrays<W> ascending, descending;
+        for (int i = 0; i < vertices; i++) {
+            int u = order[i];
+            forEachOutEdge(u, [&](int, int v, W weight) {
+                if (label[v] >= label[u])
+                    ascending.push(u, v, weight);
+                return true;
+            });
+        }
+        for (int i = vertices - 1; i >= 0; i--) {
+            int u = order[i];
+            forEachOutEdge(u, [&](int, int v, W weight) {
+                if (label[v] < label[u])
+                    descending.push(u, v, weight);
+                return true;
+            });
+        }
+
+        vector<W> distance(vertices, Traits::infinity());
+        distance[source] = 0;
+
+        int passLimit = (vertices + 1) / 2;
+        int passes = 0;
+        bool converged = false;
+        while (passes < passLimit && !converged) {
+            bool changed = relaxPass(distance, ascending);
+            changed |= relaxPass(distance, descending);
+            converged = !changed;
+            passes++;
+        }
+
+        bool hasNegativeCycle = !converged && hasRelaxableEdge(distance);
+        printResult(source, distance, hasNegativeCycle);
+        cout << "Passes needed: " << passes << " (limit " << passLimit << ")\n";
+        return passes;
+    }
+
+    // Queue-based Bellman-Ford (SPFA)
+    // Only vertices whose distance just improved can improve their
+    // neighbours, so keep them in a FIFO and relax only their outgoing edges.
+    // Each relaxation also records how many edges the improved path has; a
+    // path of V or more edges repeats a vertex, so it went around a negative
+    // cycle. (Counting raw improvements per vertex is not exact: parallel
+    // edges can improve the same vertex several times in one scan.)
+    void bellmanFordSPFA(int source) {
+        layoutEdges();
+
+        vector<W> distance(vertices, Traits::infinity());
+        vector<int> pathEdges(vertices, 0);    // Edges on the current best path
+        vector<bool> inQueue(vertices, false);
+        queue<int> pending;
+
+        distance[source] = 0;
+        pending.push(source);
+        inQueue[source] = true;
+
         bool hasNegativeCycle = false;
-        for (const Edge& edge : edges) {
-            int u = edge.source;
-            int v = edge.destination;
-            int weight = edge.weight;
-
-            if (distance[u] != INT_MAX && distance[u] + weight < distance[v]) {
-                hasNegativeCycle = true;
-                break;
+        while (!pending.empty() && !hasNegativeCycle) {
+            int u = pending.front();
+            pending.pop();
+            inQueue[u] = false;
+
+            forEachOutEdge(u, [&](int, int v, W weight) {
+                W candidate = Traits::add(distance[u], weight);
+                if (candidate < distance[v]) {
+                    distance[v] = candidate;
+                    pathEdges[v] = pathEdges[u] + 1;
+
+                    // A shortest path has at most V-1 edges
+                    if (pathEdges[v] >= vertices) {
+                        hasNegativeCycle = true;
+                        return false;
+                    }
+
+                    if (!inQueue[v]) {
+                        pending.push(v);
+                        inQueue[v] = true;
+                    }
+                }
+                return true;
+            });
+        }
+
+        printResult(source, distance, hasNegativeCycle);
+    }
+
+    // Multi-threaded Bellman-Ford
+    // Each thread owns a contiguous slice of edges for every pass; distances
+    // are lowered with an atomic fetch-min (compare-and-swap loop), so no
+    // locks are taken while relaxing. Threads meet at a barrier after each
+    // pass and stop together once a pass changes nothing.
+    // Relaxations from the same pass can see each other's results, which
+    // only speeds convergence: after V-1 passes every distance is still at
+    // least as good as the sequential algorithm's, so the final read-only
+    // pass detects negative cycles exactly.
+    void bellmanFordParallel(int source, int threadCount = 0) {
+        layoutEdges();
+
+        if (threadCount <= 0)
+            threadCount = (int)max(1u, thread::hardware_concurrency());
+
+        vector<atomic<W>> distance(vertices);
+        for (int i = 0; i < vertices; i++)
+            distance[i].store(Traits::infinity(), memory_order_relaxed);
+        distance[source].store(0, memory_order_relaxed);
+
+        atomic<int> lastChangedPass(-1);        // Highest pass that improved a distance
+        atomic<bool> hasNegativeCycle(false);
+        PassBarrier barrier(threadCount);
+
+        auto worker = [&](int t) {
+            size_t begin = edges.size() * t / threadCount;
+            size_t end = edges.size() * (t + 1) / threadCount;
+
+            int pass = 0;
+            for (; pass < vertices - 1; pass++) {
+                bool changed = false;
+
+                for (size_t i = begin; i < end; i++) {
+                    W du = distance[edges.source[i]].load(memory_order_relaxed);
+                    if (du == Traits::infinity())
+                        continue;
+
+                    // Atomic fetch-min
+                    W candidate = Traits::add(du, edges.weight[i]);
+                    atomic<W>& target = distance[edges.destination[i]];
+                    W current = target.load(memory_order_relaxed);
+                    while (candidate < current) {
+                        if (target.compare_exchange_weak(current, candidate, memory_order_relaxed)) {
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (changed)
+                    lastChangedPass.store(pass, memory_order_relaxed);
+
+                barrier.wait();
+
+                // Every thread sees the same answer here: nobody can write
+                // lastChangedPass again until all threads decided to go on
+                if (lastChangedPass.load(memory_order_relaxed) < pass)
+                    break;
             }
+
+            // Still changing after V-1 passes: look for a relaxable edge
+            if (pass == vertices - 1) {
+                for (size_t i = begin; i < end && !hasNegativeCycle.load(memory_order_relaxed); i++) {
+                    W du = distance[edges.source[i]].load(memory_order_relaxed);
+                    if (du != Traits::infinity() &&
+                        Traits::add(du, edges.weight[i]) <
+                            distance[edges.destination[i]].load(memory_order_relaxed))
+                        hasNegativeCycle.store(true, memory_order_relaxed);
+                }
+            }
+        };
+
+        vector<thread> pool;
+        for (int t = 1; t < threadCount; t++)
+            pool.emplace_back(worker, t);
+        worker(0);
+        for (thread& th : pool)
+            th.join();
+
+        vector<W> result(vertices);
+        for (int i = 0; i < vertices; i++)
+            result[i] = distance[i].load(memory_order_relaxed);
+
+        printResult(source, result, hasNegativeCycle.load());
+    }
+
+    // Find a negative cycle with subtree disassembly
+    // source = -1 searches the whole graph, otherwise only cycles reachable
+    // from source. Returns the cycle's vertices in edge order (the last one
+    // has an edge back to the first), or an empty vector if there is none.
+    vector<int> findNegativeCycle(int source = -1) {
+        layoutEdges();
+
+        ShortestPathTree<W> tree;
+        tree.reset(vertices, source);
+        return tree.propagate(*this);
+    }
+
+    // Bellman-Ford with subtree disassembly: prints distances, or the cycle
+    void bellmanFordTarjan(int source) {
+        layoutEdges();
+
+        ShortestPathTree<W> tree;
+        tree.reset(vertices, source);
+        vector<int> cycle = tree.propagate(*this);
+
+        if (!cycle.empty()) {
+            cout << "Graph contains a negative weight cycle: ";
+            for (int v : cycle)
+                cout << v << " -> ";
+            cout << cycle[0] << "\n";
+            return;
         }
 
-        // Step 4: Print results
-        if (hasNegativeCycle) {
+        printResult(source, tree.distance, false);
+    }
+
+    // Johnson's all-pairs shortest paths
+    // 1. Bellman-Ford from a virtual source joined to every vertex by a
+    //    0-weight edge gives potentials h (fails on a negative cycle)
+    // 2. Reweighted edges w(u,v) + h[u] - h[v] are never negative
+    // 3. Dijkstra (binary heap) from every source on threadCount threads;
+    //    real distance = reweighted distance - h[source] + h[target]
+    // Each finished row is passed to onRow(source, row) as soon as it is
+    // ready, so the V x V matrix never has to be held in memory. Calls are
+    // serialized but arrive in no particular source order.
+    // Returns false (and emits nothing) if the graph has a negative cycle.
+    bool johnsonAllPairs(const function<void(int, const vector<Wide>&)>& onRow,
+                         int threadCount = 0) {
+        layoutEdges();
+
+        // Step 1: potentials, accumulated in Wide so they cannot overflow W
+        ShortestPathTree<Wide> tree;
+        tree.reset(vertices, -1);
+        if (!tree.propagate(*this).empty())
+            return false;
+        const vector<Wide>& h = tree.distance;
+
+        // Step 2: reweighted edge lengths, same order as edges
+        // (clamped at 0: float rounding can leave tiny negative values)
+        vector<Wide> reweighted(edges.size());
+        for (size_t i = 0; i < edges.size(); i++) {
+            Wide length = (Wide)edges.weight[i] + h[edges.source[i]] - h[edges.destination[i]];
+            reweighted[i] = max<Wide>(0, length);
+        }
+
+        // Step 3: one Dijkstra per source, sources handed out dynamically
+        if (threadCount <= 0)
+            threadCount = (int)max(1u, thread::hardware_concurrency());
+        threadCount = max(1, min(threadCount, vertices));
+
+        const Wide unreachable = WeightTraits<Wide>::infinity();
+        atomic<int> nextSource(0);
+        mutex emitLock;
+
+        auto worker = [&]() {
+            typedef pair<Wide, int> HeapItem;        // (distance, vertex)
+            vector<Wide> distance(vertices);
+            vector<Wide> row(vertices);
+
+            for (int s = nextSource++; s < vertices; s = nextSource++) {
+                fill(distance.begin(), distance.end(), unreachable);
+                priority_queue<HeapItem, vector<HeapItem>, greater<HeapItem>> heap;
+
+                distance[s] = 0;
+                heap.push(HeapItem(0, s));
+
+                while (!heap.empty()) {
+                    HeapItem top = heap.top();
+                    heap.pop();
+                    int u = top.second;
+                    if (top.first != distance[u])
+                        continue;                    // Stale heap entry
+
+                    forEachOutEdge(u, [&](int index, int v, W) {
+                        Wide candidate = distance[u] + reweighted[index];
+                        if (candidate < distance[v]) {
+                            distance[v] = candidate;
+                            heap.push(HeapItem(candidate, v));
+                        }
+                        return true;
+                    });
+                }
+
+                // Undo the reweighting
+                for (int t = 0; t < vertices; t++) {
+                    row[t] = distance[t] == unreachable
+                                 ? unreachable
+                                 : distance[t] - h[s] + h[t];
+                }
+
+                lock_guard<mutex> guard(emitLock);
+                onRow(s, row);
+            }
+        };
+
+        vector<thread> pool;
+        for (int t = 1; t < threadCount; t++)
+            pool.emplace_back(worker);
+        worker();
+        for (thread& th : pool)
+            th.join();
+
+        return true;
+    }
+
+    // Johnson's algorithm collected into a matrix; false on a negative cycle
+    bool allPairsShortestPaths(BasicDistanceMatrix<Wide>& matrix, int threadCount = 0) {
+        matrix.vertices = vertices;
+        matrix.data.assign((size_t)vertices * vertices, BasicDistanceMatrix<Wide>::UNREACHABLE);
+
+        return johnsonAllPairs([&matrix](int source, const vector<Wide>& row) {
+            copy(row.begin(), row.end(), matrix.data.begin() + (size_t)source * matrix.vertices);
+        }, threadCount);
+    }
+
+    // Print the all-pairs distance matrix, or the negative cycle message
+    void printAllPairs(int threadCount = 0) {
+        BasicDistanceMatrix<Wide> matrix;
+        if (!allPairsShortestPaths(matrix, threadCount)) {
             cout << "Graph contains a negative weight cycle!\n";
             return;
         }
 
-        cout << "Vertex distances from source " << source << ":\n";
+        cout << "All-pairs distances (row = from, column = to):\n";
         for (int i = 0; i < vertices; i++) {
-            if (distance[i] == INT_MAX)
-                cout << "Vertex " << i << ": INF (unreachable)\n";
-            else
-                cout << "Vertex " << i << ": " << distance[i] << "\n";
+            for (int j = 0; j < vertices; j++) {
+                if (matrix.at(i, j) == BasicDistanceMatrix<Wide>::UNREACHABLE)
+                    cout << "INF\t";
+                else
+                    cout << matrix.at(i, j) << "\t";
+            }
+            cout << "\n";
         }
     }
 };
 
+typedef BasicGraph<int> Graph;
+
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
@@ -145,6 +1112,124 @@ int main() {
     g3.addEdge(2, 1, -5);
 
     g3.bellmanFord(0);
+    cout << "\n";
+
+    // Test case 4: Queue-based mode on the same graphs
+    cout << "Test 4: Queue-based (SPFA) mode\n";
+    cout << "Graph from Test 2:\n";
+    g2.bellmanFordSPFA(0);
+    cout << "Graph from Test 3:\n";
+    g3.bellmanFordSPFA(0);
+
+    // Parallel edges improve vertex 1 three times in one scan; that is not
+    // a cycle (the path to 1 still has a single edge)
+    cout << "Vertices: 0, 1\n";
+    cout << "Edges: 0->1(5), 0->1(4), 0->1(3)\n";
+    Graph parallelEdges(2);
+    parallelEdges.addEdge(0, 1, 5);
+    parallelEdges.addEdge(0, 1, 4);
+    parallelEdges.addEdge(0, 1, 3);
+    parallelEdges.bellmanFordSPFA(0);
+    cout << "\n";
+
+    // Test case 5: Multi-threaded passes on the same graphs
+    cout << "Test 5: Parallel mode (4 threads)\n";
+    cout << "Graph from Test 1:\n";
+    g1.bellmanFordParallel(0, 4);
+    cout << "Graph from Test 3:\n";
+    g3.bellmanFordParallel(0, 4);
+    cout << "\n";
+
+    // Test case 6: Report which cycle is negative
+    cout << "Test 6: Negative cycle extraction (subtree disassembly)\n";
+    cout << "Graph from Test 2:\n";
+    g2.bellmanFordTarjan(0);
+    cout << "Graph from Test 3:\n";
+    g3.bellmanFordTarjan(0);
+
+    // Currency-style graph: a negative cycle not reachable from vertex 0
+    cout << "Vertices: 0, 1, 2, 3\n";
+    cout << "Edges: 0->1(2), 2->3(-1), 3->2(-1)\n";
+    Graph g4(4);
+    g4.addEdge(0, 1, 2);
+    g4.addEdge(2, 3, -1);
+    g4.addEdge(3, 2, -1);
+
+    vector<int> fromZero = g4.findNegativeCycle(0);
+    vector<int> anywhere = g4.findNegativeCycle();
+    cout << "Cycle reachable from 0? " << (fromZero.empty() ? "No" : "Yes") << "\n";
+    cout << "Cycle anywhere: ";
+    for (int v : anywhere)
+        cout << v << " -> ";
+    cout << anywhere[0] << "\n\n";
+
+    // Test case 7: All-pairs distances with Johnson's algorithm
+    cout << "Test 7: Johnson's all-pairs shortest paths\n";
+    cout << "Graph from Test 2:\n";
+    g2.printAllPairs(2);
+    cout << "Graph from Test 3:\n";
+    g3.printAllPairs(2);
+    cout << "\n";
+
+    // Test case 8: Shortest paths kept up to date while edges change
+    cout << "Test 8: Incremental updates\n";
+    cout << "Graph from Test 1, tracked from source 0\n";
+    g1.trackShortestPaths(0);
+    g1.printTrackedPaths();
+
+    cout << "updateEdge 0->1 to 1 (cheaper):\n";
+    g1.updateEdge(0, 1, 1);
+    g1.printTrackedPaths();
+
+    cout << "updateEdge 0->2 to 6 (tree edge gets heavier):\n";
+    g1.updateEdge(0, 2, 6);
+    g1.printTrackedPaths();
+
+    cout << "addEdge 3->0(-10) (creates a negative cycle):\n";
+    g1.addEdge(3, 0, -10);
+    g1.printTrackedPaths();
+
+    cout << "updateEdge 3->0 to 10 (cycle removed):\n";
+    g1.updateEdge(3, 0, 10);
+    g1.printTrackedPaths();
+
+    // Test case 9: Other weight types
+    cout << "\nTest 9: Weight types\n";
+    cout << "double weights, Edges: 0->1(0.5), 1->2(-0.25), 0->2(0.4)\n";
+    BasicGraph<double> real(3);
+    real.addEdge(0, 1, 0.5);
+    real.addEdge(1, 2, -0.25);
+    real.addEdge(0, 2, 0.4);
+    real.bellmanFord(0);
+
+    // 0->1->2 weighs 4e9, which does not fit in an int: int weights report
+    // the overflow instead of wrapping around to a negative distance or
+    // calling vertex 2 unreachable
+    cout << "Edges: 0->1(2000000000), 1->2(2000000000)\n";
+    Graph narrow(3);
+    BasicGraph<long long> wide(3);
+    narrow.addEdge(0, 1, 2000000000);
+    narrow.addEdge(1, 2, 2000000000);
+    wide.addEdge(0, 1, 2000000000);
+    wide.addEdge(1, 2, 2000000000);
+    cout << "int weights:\n";
+    narrow.bellmanFord(0);
+    cout << "long long weights:\n";
+    wide.bellmanFord(0);
+    cout << "\n";
+
+    // Test case 10: Yen's ordering on a chain. Edges are sorted by source,
+    // so a plain pass happens to settle this chain in one sweep whatever
+    // order they were added in; Yen's passes follow a random numbering and
+    // need at most ceil(V/2) passes on any graph
+    cout << "Test 10: Yen's forward/backward passes\n";
+    cout << "Chain 0->1->...->11 (weight 1 each)\n";
+    Graph chain(12);
+    for (int v = 10; v >= 0; v--)
+        chain.addEdge(v, v + 1, 1);
+    chain.bellmanFordYen(0);
+    cout << "Graph from Test 3:\n";
+    g3.bellmanFordYen(0);
 
     return 0;
 }